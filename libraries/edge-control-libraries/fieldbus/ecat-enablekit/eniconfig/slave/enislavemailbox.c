@@ -242,10 +242,12 @@ static void ecat_eni_parse_slavemailbox_coe_initcmd(xmlNodePtr ptr, struct list_
                     }
                     initcmd->data = (uint32_t*)ecat_malloc(sizeof(uint32_t)*size);
                     if (initcmd->data) {
-                        memset(initcmd->data, 0, size);
+                        memset(initcmd->data, 0, sizeof(uint32_t)*size);
                         if (ecat_sscan_hexbinary(key, initcmd->data, size) != 0) {
                             ecat_free(initcmd->data);
                             initcmd->data = NULL;
+                        } else {
+                            initcmd->data_size = len/2;
                         }
                     }
                 }
@@ -338,12 +340,14 @@ static void ecat_eni_parse_slavemailbox_soe_initcmd(xmlNodePtr ptr, struct list_
                     if (len%8) {
                         size += 1;
                     }
-                    initcmd->data = (uint8_t*)ecat_malloc(sizeof(uint8_t)*size);
+                    initcmd->data = (uint8_t*)ecat_malloc(sizeof(uint32_t)*size);
                     if (initcmd->data) {
-                        memset(initcmd->data, 0, size);
-                        if (ecat_sscan_hexbinary(key, initcmd->data, size) != 0) {
+                        memset(initcmd->data, 0, sizeof(uint32_t)*size);
+                        if (ecat_sscan_hexbinary(key, (uint32_t*)initcmd->data, size) != 0) {
                             ecat_free(initcmd->data);
                             initcmd->data = NULL;
+                        } else {
+                            initcmd->data_size = len/2;
                         }
                     }
                 }
@@ -63,8 +63,8 @@ typedef struct {
     struct list_head initcmds_list;
 }eni_mailbox_coe_initcmds;
 
-#define ENI_SLAVE_MAILBOX_CCS_UPLOAD_TYPE       1
-#define ENI_SLAVE_MAILBOX_CCS_DOWNLOAD_TYPE     2
+#define ENI_SLAVE_MAILBOX_CCS_DOWNLOAD_TYPE     1
+#define ENI_SLAVE_MAILBOX_CCS_UPLOAD_TYPE       2
 
 /**
 * @brief eni_mailbox_coe_initcmd represents what a single slave mailbox coe command is composed
@@ -79,6 +79,7 @@ typedef struct {
     uint32_t index;               //Index of the CANopen SDO
     uint32_t subindex;            //Subindex of the CANopen SDO
     uint32_t* data;               //SDO data
+    uint32_t data_size;           //Number of bytes in data
     uint8_t  disabled;            //boolean, determines whether InitCmd shall be sent
 } eni_slave_mailbox_coe_initcmd;
 
@@ -110,6 +111,7 @@ typedef struct {
     uint32_t driveno;         // Drive number
     uint32_t idn;             //IDN for this command
     uint8_t* data;               //Data of the IDN
+    uint32_t data_size;          //Number of bytes in data
     uint8_t  disabled;            //boolean, determines whether InitCmd shall be sent
 } eni_slave_mailbox_soe_initcmd;
 
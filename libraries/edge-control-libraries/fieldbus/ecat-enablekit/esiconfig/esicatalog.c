@@ -0,0 +1,894 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2025 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions
+// and limitations under the License.
+
+/**
+ *
+ * @file esicatalog.c
+ *
+ * Indexing runs a SAX pass over each ESI file that builds no tree and keeps
+ * the Type and the byte range of every device element. A lookup reads and
+ * parses only that range. If the range no longer holds the device, the file
+ * is streamed to the device element by its position instead.
+ *
+ * Index file format, one record per line:
+ *   ESIINDEX 1
+ *   F <mtime ns> <size> <file name>
+ *   D <vendor> <product> <revision> <ordinal> <start> <end>   (devices of the last F)
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <limits.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include <libxml/parserInternals.h>
+#include <libxml/xmlreader.h>
+
+#include "esicatalog.h"
+
+#define ESI_CATALOG_LOG "ESI_CATALOG: "
+#define ESI_CATALOG_INDEX_MAGIC "ESIINDEX 1"
+#define ESI_CATALOG_LINE_SIZE (PATH_MAX + 64)
+
+enum {
+    SECTION_NONE = 0,
+    SECTION_VENDOR,
+    SECTION_DESCRIPTIONS
+};
+
+static int64_t esi_catalog_number(const xmlChar* key)
+{
+    const char* s = (const char*)key;
+
+    if (!s) {
+        return 0;
+    }
+    while ((*s == ' ') || (*s == '\t') || (*s == '\r') || (*s == '\n')) {
+        s++;
+    }
+    if ((s[0] == '#') && ((s[1] == 'x') || (s[1] == 'X'))) {
+        return (int64_t)strtoull(s + 2, NULL, 16);
+    }
+    return strtoll(s, NULL, 10);
+}
+
+static int64_t esi_catalog_prop(xmlNodePtr node, const char* name, int64_t def)
+{
+    xmlChar* key = xmlGetProp(node, BAD_CAST name);
+    int64_t val = def;
+
+    if (key) {
+        if (!xmlStrcmp(key, BAD_CAST"true")) {
+            val = 1;
+        } else if (xmlStrcmp(key, BAD_CAST"false")) {
+            val = esi_catalog_number(key);
+        } else {
+            val = 0;
+        }
+        xmlFree(key);
+    }
+    return val;
+}
+
+static int64_t esi_catalog_content(xmlNodePtr node)
+{
+    xmlChar* key = xmlNodeGetContent(node);
+    int64_t val = esi_catalog_number(key);
+
+    if (key) {
+        xmlFree(key);
+    }
+    return val;
+}
+
+static void esi_catalog_copy_content(xmlNodePtr node, char* name, size_t size)
+{
+    xmlChar* key = xmlNodeGetContent(node);
+
+    if (key) {
+        snprintf(name, size, "%s", (const char*)key);
+        xmlFree(key);
+    }
+}
+
+static char* esi_catalog_strdup(const char* s)
+{
+    size_t len = strlen(s);
+    char* p = ecat_malloc(len + 1);
+
+    if (p) {
+        memcpy(p, s, len + 1);
+    }
+    return p;
+}
+
+static esi_catalog_item* esi_catalog_add_item(ecat_esi_catalog* catalog)
+{
+    esi_catalog_item* items;
+    uint32_t capacity;
+
+    if (catalog->n_items == catalog->items_capacity) {
+        capacity = catalog->items_capacity ? catalog->items_capacity * 2 : 64;
+        items = ecat_malloc(capacity * sizeof(esi_catalog_item));
+        if (!items) {
+            MOTION_CONSOLE_ERR(ESI_CATALOG_LOG "item alloc fail\n");
+            return NULL;
+        }
+        if (catalog->items) {
+            memcpy(items, catalog->items, catalog->n_items * sizeof(esi_catalog_item));
+            ecat_free(catalog->items);
+        }
+        catalog->items = items;
+        catalog->items_capacity = capacity;
+    }
+    memset(&catalog->items[catalog->n_items], 0, sizeof(esi_catalog_item));
+    return &catalog->items[catalog->n_items++];
+}
+
+static int esi_catalog_cmp_key(const esi_catalog_item* a, uint32_t vendor_id, uint32_t product_code, uint32_t revision_no)
+{
+    if (a->vendor_id != vendor_id) {
+        return a->vendor_id < vendor_id ? -1 : 1;
+    }
+    if (a->product_code != product_code) {
+        return a->product_code < product_code ? -1 : 1;
+    }
+    if (a->revision_no != revision_no) {
+        return a->revision_no < revision_no ? -1 : 1;
+    }
+    return 0;
+}
+
+static int esi_catalog_cmp_item(const void* a, const void* b)
+{
+    const esi_catalog_item* x = a;
+    const esi_catalog_item* y = b;
+    int ret = esi_catalog_cmp_key(x, y->vendor_id, y->product_code, y->revision_no);
+
+    /* the first file and device win for duplicates */
+    if (!ret) {
+        if (x->file != y->file) {
+            ret = x->file < y->file ? -1 : 1;
+        } else if (x->ordinal != y->ordinal) {
+            ret = x->ordinal < y->ordinal ? -1 : 1;
+        }
+    }
+    return ret;
+}
+
+static int esi_catalog_cmp_position(const void* a, const void* b)
+{
+    const esi_catalog_item* x = a;
+    const esi_catalog_item* y = b;
+
+    if (x->file != y->file) {
+        return x->file < y->file ? -1 : 1;
+    }
+    if (x->ordinal != y->ordinal) {
+        return x->ordinal < y->ordinal ? -1 : 1;
+    }
+    return 0;
+}
+
+static int esi_catalog_cmp_file(const void* a, const void* b)
+{
+    return strcmp(((const esi_catalog_file*)a)->name, ((const esi_catalog_file*)b)->name);
+}
+
+static esi_catalog_device* esi_catalog_parse_device(xmlNodePtr node, uint32_t vendor_id)
+{
+    esi_catalog_device* device;
+    xmlNodePtr cur, child, sub, leaf;
+    uint32_t n_opmodes = 0, n_pdos = 0, n_entries = 0, n_sms = 0;
+    esi_catalog_pdo* pdo;
+    esi_catalog_entry* entry;
+    esi_catalog_opmode* opmode;
+    esi_catalog_sm* sm;
+    size_t size;
+
+    for (cur = node->children; cur; cur = cur->next) {
+        if (cur->type != XML_ELEMENT_NODE) {
+            continue;
+        }
+        if (!xmlStrcmp(cur->name, BAD_CAST"Sm")) {
+            n_sms++;
+        } else if ((!xmlStrcmp(cur->name, BAD_CAST"RxPdo")) || (!xmlStrcmp(cur->name, BAD_CAST"TxPdo"))) {
+            n_pdos++;
+            for (child = cur->children; child; child = child->next) {
+                if ((child->type == XML_ELEMENT_NODE) && (!xmlStrcmp(child->name, BAD_CAST"Entry"))) {
+                    n_entries++;
+                }
+            }
+        } else if ((!xmlStrcmp(cur->name, BAD_CAST"Dc")) || (!xmlStrcmp(cur->name, BAD_CAST"DC"))) {
+            for (child = cur->children; child; child = child->next) {
+                if ((child->type == XML_ELEMENT_NODE) && (!xmlStrcmp(child->name, BAD_CAST"OpMode"))) {
+                    n_opmodes++;
+                }
+            }
+        }
+    }
+    if ((n_opmodes > 0xFFFF) || (n_pdos > 0xFFFF) || (n_entries > 0xFFFF) || (n_sms > 0xFFFF)) {
+        MOTION_CONSOLE_ERR(ESI_CATALOG_LOG "device too large\n");
+        return NULL;
+    }
+
+    size = sizeof(esi_catalog_device) + n_opmodes * sizeof(esi_catalog_opmode) + n_pdos * sizeof(esi_catalog_pdo)
+        + n_entries * sizeof(esi_catalog_entry) + n_sms * sizeof(esi_catalog_sm);
+    device = ecat_malloc(size);
+    if (!device) {
+        MOTION_CONSOLE_ERR(ESI_CATALOG_LOG "device alloc fail\n");
+        return NULL;
+    }
+    memset(device, 0, size);
+    device->vendor_id = vendor_id;
+    device->opmodes = (esi_catalog_opmode*)(device + 1);
+    device->pdos = (esi_catalog_pdo*)(device->opmodes + n_opmodes);
+    device->entries = (esi_catalog_entry*)(device->pdos + n_pdos);
+    device->sms = (esi_catalog_sm*)(device->entries + n_entries);
+
+    for (cur = node->children; cur; cur = cur->next) {
+        if (cur->type != XML_ELEMENT_NODE) {
+            continue;
+        }
+        if (!xmlStrcmp(cur->name, BAD_CAST"Type")) {
+            device->product_code = (uint32_t)esi_catalog_prop(cur, "ProductCode", 0);
+            device->revision_no = (uint32_t)esi_catalog_prop(cur, "RevisionNo", 0);
+            esi_catalog_copy_content(cur, device->name, sizeof(device->name));
+        } else if (!xmlStrcmp(cur->name, BAD_CAST"Sm")) {
+            sm = &device->sms[device->n_sms++];
+            sm->start_address = (uint16_t)esi_catalog_prop(cur, "StartAddress", 0);
+            sm->default_size = (uint16_t)esi_catalog_prop(cur, "DefaultSize", 0);
+            sm->control_byte = (uint8_t)esi_catalog_prop(cur, "ControlByte", 0);
+            sm->enable = (uint8_t)esi_catalog_prop(cur, "Enable", 0);
+        } else if ((!xmlStrcmp(cur->name, BAD_CAST"RxPdo")) || (!xmlStrcmp(cur->name, BAD_CAST"TxPdo"))) {
+            pdo = &device->pdos[device->n_pdos++];
+            pdo->sm_id = (uint8_t)esi_catalog_prop(cur, "Sm", ESI_CATALOG_NO_SM);
+            pdo->fixed = (uint8_t)esi_catalog_prop(cur, "Fixed", 0);
+            pdo->direction = (cur->name[0] == 'T') ? EC_DIR_INPUT : EC_DIR_OUTPUT;
+            pdo->first_entry = device->n_entries;
+            for (child = cur->children; child; child = child->next) {
+                if (child->type != XML_ELEMENT_NODE) {
+                    continue;
+                }
+                if (!xmlStrcmp(child->name, BAD_CAST"Index")) {
+                    pdo->index = (uint16_t)esi_catalog_content(child);
+                } else if (!xmlStrcmp(child->name, BAD_CAST"Entry")) {
+                    entry = &device->entries[device->n_entries++];
+                    pdo->n_entries++;
+                    for (sub = child->children; sub; sub = sub->next) {
+                        if (!xmlStrcmp(sub->name, BAD_CAST"Index")) {
+                            entry->index = (uint16_t)esi_catalog_content(sub);
+                        } else if (!xmlStrcmp(sub->name, BAD_CAST"SubIndex")) {
+                            entry->subIndex = (uint8_t)esi_catalog_content(sub);
+                        } else if (!xmlStrcmp(sub->name, BAD_CAST"BitLen")) {
+                            entry->bitLen = (uint8_t)esi_catalog_content(sub);
+                        }
+                    }
+                }
+            }
+            if (pdo->sm_id < ESI_CATALOG_MAX_SM) {
+                device->sm_pdos[pdo->sm_id]++;
+                if (device->sm_size < pdo->sm_id + 1) {
+                    device->sm_size = pdo->sm_id + 1;
+                }
+            }
+        } else if ((!xmlStrcmp(cur->name, BAD_CAST"Dc")) || (!xmlStrcmp(cur->name, BAD_CAST"DC"))) {
+            for (child = cur->children; child; child = child->next) {
+                if ((child->type != XML_ELEMENT_NODE) || (xmlStrcmp(child->name, BAD_CAST"OpMode"))) {
+                    continue;
+                }
+                opmode = &device->opmodes[device->n_opmodes++];
+                for (sub = child->children; sub; sub = sub->next) {
+                    if (!xmlStrcmp(sub->name, BAD_CAST"Name")) {
+                        esi_catalog_copy_content(sub, opmode->name, sizeof(opmode->name));
+                    } else if (!xmlStrcmp(sub->name, BAD_CAST"AssignActivate")) {
+                        opmode->assign_activate = (uint16_t)esi_catalog_content(sub);
+                    } else if (!xmlStrcmp(sub->name, BAD_CAST"CycleTimeSync0")) {
+                        opmode->cycletimesync0 = (int32_t)esi_catalog_content(sub);
+                    } else if (!xmlStrcmp(sub->name, BAD_CAST"ShiftTimeSync0")) {
+                        opmode->shifttimesync0 = (int32_t)esi_catalog_content(sub);
+                    } else if (!xmlStrcmp(sub->name, BAD_CAST"CycleTimeSync1")) {
+                        opmode->cycletimesync1 = (int32_t)esi_catalog_content(sub);
+                    } else if (!xmlStrcmp(sub->name, BAD_CAST"ShiftTimeSync1")) {
+                        opmode->shifttimesync1 = (int32_t)esi_catalog_content(sub);
+                    }
+                }
+            }
+        } else if (!xmlStrcmp(cur->name, BAD_CAST"Info")) {
+            for (child = cur->children; child; child = child->next) {
+                if (xmlStrcmp(child->name, BAD_CAST"Mailbox")) {
+                    continue;
+                }
+                for (sub = child->children; sub; sub = sub->next) {
+                    if (xmlStrcmp(sub->name, BAD_CAST"Timeout")) {
+                        continue;
+                    }
+                    for (leaf = sub->children; leaf; leaf = leaf->next) {
+                        if (!xmlStrcmp(leaf->name, BAD_CAST"RequestTimeout")) {
+                            device->request_timeout = (uint32_t)esi_catalog_content(leaf);
+                        } else if (!xmlStrcmp(leaf->name, BAD_CAST"ResponseTimeout")) {
+                            device->response_timeout = (uint32_t)esi_catalog_content(leaf);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return device;
+}
+
+typedef struct {
+    ecat_esi_catalog* catalog;
+    xmlParserCtxtPtr ctxt;
+    esi_catalog_item* item;     ///Device being scanned
+    uint32_t file;
+    uint32_t vendor_id;
+    uint32_t ordinal;
+    int depth;
+    int section;
+    int in_devices;
+    int in_vendor_id;
+    int has_type;
+    int failed;
+    char text[32];
+    uint32_t text_len;
+}esi_catalog_scan;
+
+/* File offset of the '<' of the start tag just parsed */
+static int64_t esi_catalog_tag_start(xmlParserCtxtPtr ctxt)
+{
+    const xmlChar* p = ctxt->input->cur;
+
+    while ((p > ctxt->input->base) && (*p != '<')) {
+        p--;
+    }
+    return (int64_t)xmlByteConsumed(ctxt) - (ctxt->input->cur - p);
+}
+
+static void esi_catalog_scan_start(void* ctx, const xmlChar* localname, const xmlChar* prefix, const xmlChar* URI,
+    int nb_namespaces, const xmlChar** namespaces, int nb_attributes, int nb_defaulted, const xmlChar** attributes)
+{
+    esi_catalog_scan* scan = (esi_catalog_scan*)ctx;
+    int depth = scan->depth++;
+    char value[32];
+    int i, len;
+
+    if (scan->failed) {
+        return;
+    }
+    if (depth == 0) {
+        if (xmlStrcmp(localname, BAD_CAST"EtherCATInfo")) {
+            scan->failed = 1;
+            xmlStopParser(scan->ctxt);
+        }
+    } else if (depth == 1) {
+        if (!xmlStrcmp(localname, BAD_CAST"Vendor")) {
+            scan->section = SECTION_VENDOR;
+        } else if (!xmlStrcmp(localname, BAD_CAST"Descriptions")) {
+            scan->section = SECTION_DESCRIPTIONS;
+        } else {
+            scan->section = SECTION_NONE;
+        }
+    } else if (depth == 2) {
+        scan->in_vendor_id = (scan->section == SECTION_VENDOR) && !xmlStrcmp(localname, BAD_CAST"Id");
+        scan->in_devices = (scan->section == SECTION_DESCRIPTIONS) && !xmlStrcmp(localname, BAD_CAST"Devices");
+        scan->text_len = 0;
+    } else if ((depth == 3) && scan->in_devices && !xmlStrcmp(localname, BAD_CAST"Device")) {
+        scan->item = esi_catalog_add_item(scan->catalog);
+        if (!scan->item) {
+            scan->failed = 1;
+            xmlStopParser(scan->ctxt);
+            return;
+        }
+        scan->item->vendor_id = scan->vendor_id;
+        scan->item->file = scan->file;
+        scan->item->ordinal = scan->ordinal++;
+        scan->item->start = esi_catalog_tag_start(scan->ctxt);
+        scan->has_type = 0;
+    } else if ((depth == 4) && scan->item && !scan->has_type && !xmlStrcmp(localname, BAD_CAST"Type")) {
+        /* attributes are localname/prefix/URI/value/end */
+        for (i = 0; i < nb_attributes; i++) {
+            len = attributes[i * 5 + 4] - attributes[i * 5 + 3];
+            snprintf(value, sizeof(value), "%.*s", len, (const char*)attributes[i * 5 + 3]);
+            if (!xmlStrcmp(attributes[i * 5], BAD_CAST"ProductCode")) {
+                scan->item->product_code = (uint32_t)esi_catalog_number(BAD_CAST value);
+            } else if (!xmlStrcmp(attributes[i * 5], BAD_CAST"RevisionNo")) {
+                scan->item->revision_no = (uint32_t)esi_catalog_number(BAD_CAST value);
+            }
+        }
+        scan->has_type = 1;
+    }
+}
+
+static void esi_catalog_scan_end(void* ctx, const xmlChar* localname, const xmlChar* prefix, const xmlChar* URI)
+{
+    esi_catalog_scan* scan = (esi_catalog_scan*)ctx;
+    int depth = --scan->depth;
+
+    if (scan->failed) {
+        return;
+    }
+    if ((depth == 3) && scan->item) {
+        scan->item->end = (int64_t)xmlByteConsumed(scan->ctxt);
+        if (!scan->has_type) {
+            /* still the last item */
+            scan->catalog->n_items--;
+        }
+        scan->item = NULL;
+    } else if ((depth == 2) && scan->in_vendor_id) {
+        scan->text[scan->text_len] = '\0';
+        scan->vendor_id = (uint32_t)esi_catalog_number(BAD_CAST scan->text);
+        scan->in_vendor_id = 0;
+    }
+}
+
+static void esi_catalog_scan_characters(void* ctx, const xmlChar* ch, int len)
+{
+    esi_catalog_scan* scan = (esi_catalog_scan*)ctx;
+
+    if (scan->in_vendor_id) {
+        while ((len-- > 0) && (scan->text_len < sizeof(scan->text) - 1)) {
+            scan->text[scan->text_len++] = *ch++;
+        }
+    }
+}
+
+/* Indexes every device of the file with the byte range of its element */
+static int esi_catalog_scan_file(ecat_esi_catalog* catalog, uint32_t file)
+{
+    char path[PATH_MAX];
+    esi_catalog_scan scan;
+    xmlSAXHandler sax;
+    uint32_t n_items = catalog->n_items;
+    int ret;
+
+    snprintf(path, sizeof(path), "%s/%s", catalog->dir, catalog->files[file].name);
+    memset(&scan, 0, sizeof(scan));
+    scan.catalog = catalog;
+    scan.file = file;
+    scan.ctxt = xmlCreateFileParserCtxt(path);
+    if (!scan.ctxt) {
+        MOTION_CONSOLE_ERR(ESI_CATALOG_LOG "Failed to open %s\n", path);
+        return -1;
+    }
+    memset(&sax, 0, sizeof(sax));
+    sax.initialized = XML_SAX2_MAGIC;
+    sax.startElementNs = esi_catalog_scan_start;
+    sax.endElementNs = esi_catalog_scan_end;
+    sax.characters = esi_catalog_scan_characters;
+    memcpy(scan.ctxt->sax, &sax, sizeof(sax));
+    scan.ctxt->userData = &scan;
+    scan.ctxt->options |= XML_PARSE_NONET;
+
+    xmlParseDocument(scan.ctxt);
+    ret = (scan.ctxt->wellFormed && !scan.failed) ? 0 : -1;
+    xmlFreeParserCtxt(scan.ctxt);
+    if (ret) {
+        MOTION_CONSOLE_ERR(ESI_CATALOG_LOG "Failed to parse %s\n", path);
+        catalog->n_items = n_items;
+    }
+    return ret;
+}
+
+/* Parses the byte range of the device element, with the XML declaration of the file */
+static esi_catalog_device* esi_catalog_load_range(ecat_esi_catalog* catalog, esi_catalog_item* item)
+{
+    char path[PATH_MAX];
+    char prolog[256];
+    esi_catalog_device* device = NULL;
+    xmlDocPtr doc = NULL;
+    xmlNodePtr root;
+    size_t prolog_len = 0, len;
+    char* buf = NULL;
+    char* decl;
+    FILE* fp;
+
+    if ((item->end <= item->start) || (item->start < 0)) {
+        return NULL;
+    }
+    snprintf(path, sizeof(path), "%s/%s", catalog->dir, catalog->files[item->file].name);
+    fp = fopen(path, "rb");
+    if (!fp) {
+        return NULL;
+    }
+    len = fread(prolog, 1, sizeof(prolog) - 1, fp);
+    prolog[len] = '\0';
+    decl = strstr(prolog, "<?xml");
+    if (decl && (decl - prolog <= 3) && strstr(decl, "?>")) {
+        prolog_len = strstr(decl, "?>") + 2 - prolog;
+    }
+    len = (size_t)(item->end - item->start);
+    buf = ecat_malloc(prolog_len + len);
+    if (buf && !fseek(fp, item->start, SEEK_SET) && (fread(buf + prolog_len, 1, len, fp) == len)
+        && !strncmp(buf + prolog_len, "<Device", 7)) {
+        memcpy(buf, prolog, prolog_len);
+        doc = xmlReadMemory(buf, (int)(prolog_len + len), NULL, NULL,
+            XML_PARSE_NONET | XML_PARSE_NOERROR | XML_PARSE_NOWARNING);
+    }
+    fclose(fp);
+    if (doc) {
+        root = xmlDocGetRootElement(doc);
+        if (root && !xmlStrcmp(root->name, BAD_CAST"Device")) {
+            device = esi_catalog_parse_device(root, item->vendor_id);
+        }
+        xmlFreeDoc(doc);
+    }
+    if (buf) {
+        ecat_free(buf);
+    }
+    return device;
+}
+
+/* Streams through the file to the device element of the item, the fallback for a bad range */
+static esi_catalog_device* esi_catalog_load_walk(ecat_esi_catalog* catalog, esi_catalog_item* item)
+{
+    char path[PATH_MAX];
+    esi_catalog_device* device = NULL;
+    xmlTextReaderPtr reader;
+    const xmlChar* name;
+    xmlNodePtr node;
+    uint32_t ordinal = 0;
+    int section = SECTION_NONE;
+    int depth, ret;
+
+    snprintf(path, sizeof(path), "%s/%s", catalog->dir, catalog->files[item->file].name);
+    reader = xmlReaderForFile(path, NULL, XML_PARSE_NONET);
+    if (!reader) {
+        MOTION_CONSOLE_ERR(ESI_CATALOG_LOG "Failed to open %s\n", path);
+        return NULL;
+    }
+    ret = xmlTextReaderRead(reader);
+    while (ret == 1) {
+        if (xmlTextReaderNodeType(reader) != XML_READER_TYPE_ELEMENT) {
+            ret = xmlTextReaderRead(reader);
+            continue;
+        }
+        depth = xmlTextReaderDepth(reader);
+        name = xmlTextReaderConstLocalName(reader);
+        if (depth == 0) {
+            ret = xmlTextReaderRead(reader);
+        } else if (depth == 1) {
+            section = xmlStrcmp(name, BAD_CAST"Descriptions") ? SECTION_NONE : SECTION_DESCRIPTIONS;
+            ret = (section == SECTION_DESCRIPTIONS) ? xmlTextReaderRead(reader) : xmlTextReaderNext(reader);
+        } else if ((section == SECTION_DESCRIPTIONS) && (depth == 2) && (!xmlStrcmp(name, BAD_CAST"Devices"))) {
+            ret = xmlTextReaderRead(reader);
+        } else if ((section == SECTION_DESCRIPTIONS) && (depth == 3) && (!xmlStrcmp(name, BAD_CAST"Device"))
+            && (ordinal++ == item->ordinal)) {
+            node = xmlTextReaderExpand(reader);
+            if (node) {
+                device = esi_catalog_parse_device(node, item->vendor_id);
+            }
+            break;
+        } else {
+            ret = xmlTextReaderNext(reader);
+        }
+    }
+    xmlFreeTextReader(reader);
+    return device;
+}
+
+static int esi_catalog_list(ecat_esi_catalog* catalog)
+{
+    char path[PATH_MAX];
+    struct dirent* ent;
+    struct stat st;
+    esi_catalog_file* files;
+    uint32_t capacity = 0;
+    size_t len;
+    DIR* dir;
+
+    dir = opendir(catalog->dir);
+    if (!dir) {
+        MOTION_CONSOLE_ERR(ESI_CATALOG_LOG "Failed to open directory %s\n", catalog->dir);
+        return -1;
+    }
+    while ((ent = readdir(dir)) != NULL) {
+        len = strlen(ent->d_name);
+        if ((len < 5) || strcasecmp(ent->d_name + len - 4, ".xml")) {
+            continue;
+        }
+        snprintf(path, sizeof(path), "%s/%s", catalog->dir, ent->d_name);
+        if (stat(path, &st) || !S_ISREG(st.st_mode)) {
+            continue;
+        }
+        if (catalog->n_files == capacity) {
+            capacity = capacity ? capacity * 2 : 16;
+            files = ecat_malloc(capacity * sizeof(esi_catalog_file));
+            if (!files) {
+                closedir(dir);
+                return -1;
+            }
+            if (catalog->files) {
+                memcpy(files, catalog->files, catalog->n_files * sizeof(esi_catalog_file));
+                ecat_free(catalog->files);
+            }
+            catalog->files = files;
+        }
+        files = &catalog->files[catalog->n_files];
+        files->name = esi_catalog_strdup(ent->d_name);
+        if (!files->name) {
+            closedir(dir);
+            return -1;
+        }
+        files->mtime = (int64_t)st.st_mtim.tv_sec * 1000000000LL + st.st_mtim.tv_nsec;
+        files->size = (int64_t)st.st_size;
+        catalog->n_files++;
+    }
+    closedir(dir);
+    if (catalog->n_files) {
+        qsort(catalog->files, catalog->n_files, sizeof(esi_catalog_file), esi_catalog_cmp_file);
+    }
+    return 0;
+}
+
+/* Takes the devices of unchanged files from the index, returns 1 if it is stale */
+static int esi_catalog_load_index(ecat_esi_catalog* catalog, uint8_t* indexed)
+{
+    char line[ESI_CATALOG_LINE_SIZE];
+    esi_catalog_file key, *found;
+    esi_catalog_item* item;
+    long long mtime, size;
+    unsigned int vendor_id, product_code, revision_no, ordinal;
+    long long start, end;
+    int64_t file = -1;
+    int offset = 0;
+    int stale = 0;
+    FILE* fp;
+
+    fp = fopen(catalog->index_path, "r");
+    if (!fp) {
+        return 1;
+    }
+    if (!fgets(line, sizeof(line), fp) || strncmp(line, ESI_CATALOG_INDEX_MAGIC, strlen(ESI_CATALOG_INDEX_MAGIC))) {
+        fclose(fp);
+        return 1;
+    }
+    while (fgets(line, sizeof(line), fp)) {
+        line[strcspn(line, "\n")] = '\0';
+        if ((line[0] == 'F') && (sscanf(line, "F %lld %lld %n", &mtime, &size, &offset) == 2) && offset) {
+            key.name = line + offset;
+            found = catalog->n_files ? bsearch(&key, catalog->files, catalog->n_files, sizeof(esi_catalog_file),
+                esi_catalog_cmp_file) : NULL;
+            file = -1;
+            if (found && (found->mtime == mtime) && (found->size == size) && !indexed[found - catalog->files]) {
+                file = found - catalog->files;
+                indexed[file] = 1;
+            } else {
+                stale = 1;
+            }
+        } else if ((line[0] == 'D') && (file >= 0)
+            && (sscanf(line, "D %x %x %x %u %lld %lld", &vendor_id, &product_code, &revision_no, &ordinal,
+            &start, &end) == 6)) {
+            item = esi_catalog_add_item(catalog);
+            if (!item) {
+                break;
+            }
+            item->vendor_id = vendor_id;
+            item->product_code = product_code;
+            item->revision_no = revision_no;
+            item->file = (uint32_t)file;
+            item->ordinal = ordinal;
+            item->start = start;
+            item->end = end;
+        }
+    }
+    fclose(fp);
+    return stale;
+}
+
+static void esi_catalog_write_index(ecat_esi_catalog* catalog)
+{
+    char tmp[PATH_MAX];
+    esi_catalog_item* item;
+    uint32_t i, f;
+    FILE* fp;
+
+    snprintf(tmp, sizeof(tmp), "%s.tmp", catalog->index_path);
+    fp = fopen(tmp, "w");
+    if (!fp) {
+        MOTION_CONSOLE_WARN(ESI_CATALOG_LOG "Failed to write index %s\n", tmp);
+        return;
+    }
+    if (catalog->n_items) {
+        qsort(catalog->items, catalog->n_items, sizeof(esi_catalog_item), esi_catalog_cmp_position);
+    }
+    fprintf(fp, "%s\n", ESI_CATALOG_INDEX_MAGIC);
+    for (f = 0, i = 0; f < catalog->n_files; f++) {
+        fprintf(fp, "F %lld %lld %s\n", (long long)catalog->files[f].mtime, (long long)catalog->files[f].size,
+            catalog->files[f].name);
+        for (; (i < catalog->n_items) && (catalog->items[i].file == f); i++) {
+            item = &catalog->items[i];
+            fprintf(fp, "D %x %x %x %u %lld %lld\n", item->vendor_id, item->product_code, item->revision_no,
+                item->ordinal, (long long)item->start, (long long)item->end);
+        }
+    }
+    if (fclose(fp) || rename(tmp, catalog->index_path)) {
+        MOTION_CONSOLE_WARN(ESI_CATALOG_LOG "Failed to write index %s\n", catalog->index_path);
+        remove(tmp);
+    }
+}
+
+ecat_esi_catalog* ecat_esi_catalog_open(const char* dir, const char* index_path)
+{
+    char path[PATH_MAX];
+    ecat_esi_catalog* catalog;
+    uint8_t* indexed = NULL;
+    int stale;
+    uint32_t f;
+
+    if (!dir) {
+        MOTION_CONSOLE_ERR(ESI_CATALOG_LOG "ESI directory is Null!\n");
+        return NULL;
+    }
+    catalog = (ecat_esi_catalog*)ecat_malloc(sizeof(ecat_esi_catalog));
+    if (!catalog) {
+        MOTION_CONSOLE_ERR(ESI_CATALOG_LOG "catalog alloc fail\n");
+        return NULL;
+    }
+    memset(catalog, 0, sizeof(ecat_esi_catalog));
+    if (!index_path) {
+        snprintf(path, sizeof(path), "%s/%s", dir, ESI_CATALOG_INDEX_NAME);
+        index_path = path;
+    }
+    catalog->dir = esi_catalog_strdup(dir);
+    catalog->index_path = esi_catalog_strdup(index_path);
+    if (!catalog->dir || !catalog->index_path || esi_catalog_list(catalog)) {
+        goto FAILED;
+    }
+    if (catalog->n_files) {
+        indexed = ecat_malloc(catalog->n_files);
+        if (!indexed) {
+            goto FAILED;
+        }
+        memset(indexed, 0, catalog->n_files);
+    }
+
+    stale = esi_catalog_load_index(catalog, indexed);
+    for (f = 0; f < catalog->n_files; f++) {
+        if (!indexed[f]) {
+            esi_catalog_scan_file(catalog, f);
+            catalog->n_scanned++;
+            stale = 1;
+        }
+    }
+    if (indexed) {
+        ecat_free(indexed);
+    }
+    if (stale) {
+        esi_catalog_write_index(catalog);
+    }
+    if (catalog->n_items) {
+        qsort(catalog->items, catalog->n_items, sizeof(esi_catalog_item), esi_catalog_cmp_item);
+    }
+    return catalog;
+FAILED:
+    MOTION_CONSOLE_ERR(ESI_CATALOG_LOG "Failed to open catalog of %s\n", dir);
+    ecat_esi_catalog_close(catalog);
+    return NULL;
+}
+
+void ecat_esi_catalog_close(ecat_esi_catalog* catalog)
+{
+    uint32_t i;
+
+    if (!catalog) {
+        return;
+    }
+    for (i = 0; i < catalog->n_items; i++) {
+        if (catalog->items[i].device) {
+            ecat_free(catalog->items[i].device);
+        }
+    }
+    for (i = 0; i < catalog->n_files; i++) {
+        ecat_free(catalog->files[i].name);
+    }
+    if (catalog->items) {
+        ecat_free(catalog->items);
+    }
+    if (catalog->files) {
+        ecat_free(catalog->files);
+    }
+    if (catalog->dir) {
+        ecat_free(catalog->dir);
+    }
+    if (catalog->index_path) {
+        ecat_free(catalog->index_path);
+    }
+    ecat_free(catalog);
+}
+
+static int esi_catalog_device_matches(const esi_catalog_device* device, const esi_catalog_item* item)
+{
+    return device && (device->product_code == item->product_code) && (device->revision_no == item->revision_no);
+}
+
+const esi_catalog_device* ecat_esi_catalog_find(ecat_esi_catalog* catalog, uint32_t vendor_id, uint32_t product_code, uint32_t revision_no)
+{
+    esi_catalog_device* device;
+    esi_catalog_item* item;
+    uint32_t lo = 0, hi, mid;
+    uint32_t revision = (revision_no == ESI_CATALOG_ANY_REVISION) ? 0 : revision_no;
+
+    if (!catalog) {
+        return NULL;
+    }
+    hi = catalog->n_items;
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        if (esi_catalog_cmp_key(&catalog->items[mid], vendor_id, product_code, revision) < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if ((lo == catalog->n_items) || (catalog->items[lo].vendor_id != vendor_id)
+        || (catalog->items[lo].product_code != product_code)) {
+        return NULL;
+    }
+    if (revision_no == ESI_CATALOG_ANY_REVISION) {
+        /* highest revision, first file for duplicates */
+        while ((lo + 1 < catalog->n_items) && (catalog->items[lo + 1].vendor_id == vendor_id)
+            && (catalog->items[lo + 1].product_code == product_code)) {
+            lo++;
+        }
+        while (lo && !esi_catalog_cmp_key(&catalog->items[lo - 1], vendor_id, product_code,
+            catalog->items[lo].revision_no)) {
+            lo--;
+        }
+    } else if (catalog->items[lo].revision_no != revision_no) {
+        return NULL;
+    }
+
+    item = &catalog->items[lo];
+    if (item->device) {
+        return item->device;
+    }
+    device = esi_catalog_load_range(catalog, item);
+    if (!esi_catalog_device_matches(device, item)) {
+        if (device) {
+            ecat_free(device);
+        }
+        device = esi_catalog_load_walk(catalog, item);
+    }
+    if (!esi_catalog_device_matches(device, item)) {
+        MOTION_CONSOLE_ERR(ESI_CATALOG_LOG "%s changed since it was indexed\n", catalog->files[item->file].name);
+        if (device) {
+            ecat_free(device);
+        }
+        return NULL;
+    }
+    catalog->n_parsed++;
+    item->device = device;
+    return device;
+}
+
+uint16_t ecat_esi_catalog_get_pdo_size_by_sm_id(const esi_catalog_device* device, uint16_t sm_id)
+{
+    if ((!device) || (sm_id >= ESI_CATALOG_MAX_SM)) {
+        return 0;
+    }
+    return device->sm_pdos[sm_id];
+}
+
+uint16_t ecat_esi_catalog_get_sm_size(const esi_catalog_device* device)
+{
+    if (!device) {
+        return 0;
+    }
+    return device->sm_size;
+}
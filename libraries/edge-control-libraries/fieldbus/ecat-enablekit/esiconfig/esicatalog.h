@@ -0,0 +1,159 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2025 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions
+// and limitations under the License.
+
+/**
+ *
+ * @file esicatalog.h
+ *
+ */
+
+#ifndef __ESI_CATALOG_H__
+#define __ESI_CATALOG_H__
+
+#include "esicommon.h"
+
+#define ESI_CATALOG_INDEX_NAME      ".esi_index"
+#define ESI_CATALOG_ANY_REVISION    (0xFFFFFFFF)
+#define ESI_CATALOG_NO_SM           (0xFF)
+#define ESI_CATALOG_MAX_SM          (16)
+#define ESI_CATALOG_NAME_SIZE       (64)
+#define ESI_CATALOG_OPMODE_NAME_SIZE (32)
+
+typedef struct {
+    uint16_t index;
+    uint8_t subIndex;
+    uint8_t bitLen;
+}esi_catalog_entry;
+
+typedef struct {
+    uint16_t index;
+    uint8_t sm_id;              ///SyncManager, ESI_CATALOG_NO_SM if not assigned
+    uint8_t fixed;
+    ec_direction_t direction;
+    uint16_t first_entry;       ///First entry in the entries array of the device
+    uint16_t n_entries;
+}esi_catalog_pdo;
+
+typedef struct {
+    uint16_t start_address;
+    uint16_t default_size;
+    uint8_t control_byte;
+    uint8_t enable;
+}esi_catalog_sm;
+
+typedef struct {
+    char name[ESI_CATALOG_OPMODE_NAME_SIZE];
+    uint16_t assign_activate;
+    int32_t cycletimesync0;
+    int32_t shifttimesync0;
+    int32_t cycletimesync1;
+    int32_t shifttimesync1;
+}esi_catalog_opmode;
+
+/**
+ *@brief One ESI device element, parsed into flat arrays in a single allocation
+ */
+typedef struct {
+    uint32_t vendor_id;
+    uint32_t product_code;
+    uint32_t revision_no;
+    char name[ESI_CATALOG_NAME_SIZE];
+    uint32_t request_timeout;
+    uint32_t response_timeout;
+    esi_catalog_opmode* opmodes;
+    esi_catalog_pdo* pdos;
+    esi_catalog_entry* entries;
+    esi_catalog_sm* sms;
+    uint16_t n_opmodes;
+    uint16_t n_pdos;
+    uint16_t n_entries;
+    uint16_t n_sms;
+    uint8_t sm_pdos[ESI_CATALOG_MAX_SM];   ///Number of PDOs assigned to each SyncManager
+    uint8_t sm_size;                        ///Highest assigned SyncManager + 1
+}esi_catalog_device;
+
+typedef struct {
+    uint32_t vendor_id;
+    uint32_t product_code;
+    uint32_t revision_no;
+    uint32_t file;              ///Index in the files array
+    uint32_t ordinal;           ///Position of the device element in its file
+    int64_t start;              ///Byte range of the device element
+    int64_t end;
+    esi_catalog_device* device; ///Parsed on the first lookup
+}esi_catalog_item;
+
+typedef struct {
+    char* name;
+    int64_t mtime;
+    int64_t size;
+}esi_catalog_file;
+
+/**
+ *@brief Devices of a directory of ESI files, sorted by vendor, product and revision
+ */
+typedef struct {
+    char* dir;
+    char* index_path;
+    esi_catalog_file* files;
+    uint32_t n_files;
+    esi_catalog_item* items;
+    uint32_t n_items;
+    uint32_t items_capacity;
+    uint32_t n_scanned;         ///Files read at open because the index was missing or stale
+    uint32_t n_parsed;          ///Device elements parsed so far
+}ecat_esi_catalog;
+
+/**
+ * @brief Open the catalogue of a directory of ESI files.
+ * The index is read from index_path and refreshed for the files that were
+ * added, changed or removed since it was written.
+ * @param dir Directory of the ESI .xml files.
+ * @param index_path Index file, NULL for ESI_CATALOG_INDEX_NAME in dir.
+ * @return The catalogue, NULL on failure.
+ */
+ecat_esi_catalog* ecat_esi_catalog_open(const char* dir, const char* index_path);
+
+/**
+ * @brief Close the catalogue and free all parsed devices.
+ * @param catalog The catalogue.
+ */
+void ecat_esi_catalog_close(ecat_esi_catalog* catalog);
+
+/**
+ * @brief Find a device, parsing its element on the first lookup.
+ * @param catalog The catalogue.
+ * @param vendor_id Vendor ID.
+ * @param product_code Product code.
+ * @param revision_no Revision, ESI_CATALOG_ANY_REVISION for the highest one.
+ * @return The device owned by the catalogue, NULL if not found.
+ */
+const esi_catalog_device* ecat_esi_catalog_find(ecat_esi_catalog* catalog, uint32_t vendor_id, uint32_t product_code, uint32_t revision_no);
+
+/**
+ * @brief Get PDO size by sm_id.
+ * @param device Catalogue device.
+ * @param sm_id SyncManager ID.
+ * @return Number of PDOs assigned to the SyncManager.
+ */
+uint16_t ecat_esi_catalog_get_pdo_size_by_sm_id(const esi_catalog_device* device, uint16_t sm_id);
+
+/**
+ * @brief Get SyncManager size of a catalogue device.
+ * @param device Catalogue device.
+ * @return Highest SyncManager with PDOs assigned + 1.
+ */
+uint16_t ecat_esi_catalog_get_sm_size(const esi_catalog_device* device);
+#endif
@@ -0,0 +1,402 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2025 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions
+// and limitations under the License.
+
+/**
+ *
+ * @file motioncia402.c
+ *
+ * The axes are kept in one array and stepped in a single pass. The drive
+ * state is looked up from the statusword bits in a table and the
+ * controlword from a state/request table, only fault reset and homing keep
+ * a step of their own.
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "motioncia402.h"
+#include "debug.h"
+#include "common.h"
+
+#define MOTIONCIA402_LOG "MOTION_CIA402: "
+
+/* Statusword bits 0-3, 5 and 6 as table index */
+#define CIA402_SW_INDEX(sw) (((sw) & 0x0F) | (((sw) >> 1) & 0x30))
+#define CIA402_SW_INDEX_COUNT (64)
+
+/* Attained bit of an earlier homing is trusted after this many cycles */
+#define CIA402_HOME_SETTLE_CYCLES (8)
+
+enum{
+    HOME_IDLE = 0,
+    HOME_ENABLE,    /**< Enable the drive in MODE_HM. */
+    HOME_START,     /**< Start bit set, attained bit not yet cleared. */
+    HOME_RUN        /**< Attained bit cleared, homing in progress. */
+};
+
+enum{
+    RESET_IDLE = 0,
+    RESET_HIGH      /**< Fault reset bit held. */
+};
+
+/* motion_cia402_decode() of every CIA402_SW_INDEX(), index bits 4 and 5 are
+ * statusword bits 5 and 6 */
+static const uint8_t cia402_state_table[CIA402_SW_INDEX_COUNT] = {
+    [0x00] = CIA402_STATE_NOT_READY,
+    [0x01] = CIA402_STATE_NOT_READY,
+    [0x02] = CIA402_STATE_NOT_READY,
+    [0x03] = CIA402_STATE_NOT_READY,
+    [0x04] = CIA402_STATE_NOT_READY,
+    [0x05] = CIA402_STATE_NOT_READY,
+    [0x06] = CIA402_STATE_NOT_READY,
+    [0x07] = CIA402_STATE_QUICK_STOP_ACTIVE,
+    [0x08] = CIA402_STATE_FAULT,
+    [0x09] = CIA402_STATE_NOT_READY,
+    [0x0A] = CIA402_STATE_NOT_READY,
+    [0x0B] = CIA402_STATE_NOT_READY,
+    [0x0C] = CIA402_STATE_NOT_READY,
+    [0x0D] = CIA402_STATE_NOT_READY,
+    [0x0E] = CIA402_STATE_NOT_READY,
+    [0x0F] = CIA402_STATE_FAULT_REACTION_ACTIVE,
+    [0x10] = CIA402_STATE_NOT_READY,
+    [0x11] = CIA402_STATE_READY_TO_SWITCH_ON,
+    [0x12] = CIA402_STATE_NOT_READY,
+    [0x13] = CIA402_STATE_SWITCHED_ON,
+    [0x14] = CIA402_STATE_NOT_READY,
+    [0x15] = CIA402_STATE_NOT_READY,
+    [0x16] = CIA402_STATE_NOT_READY,
+    [0x17] = CIA402_STATE_OPERATION_ENABLED,
+    [0x18] = CIA402_STATE_FAULT,
+    [0x19] = CIA402_STATE_NOT_READY,
+    [0x1A] = CIA402_STATE_NOT_READY,
+    [0x1B] = CIA402_STATE_NOT_READY,
+    [0x1C] = CIA402_STATE_NOT_READY,
+    [0x1D] = CIA402_STATE_NOT_READY,
+    [0x1E] = CIA402_STATE_NOT_READY,
+    [0x1F] = CIA402_STATE_FAULT_REACTION_ACTIVE,
+    [0x20] = CIA402_STATE_SWITCH_ON_DISABLED,
+    [0x21] = CIA402_STATE_NOT_READY,
+    [0x22] = CIA402_STATE_NOT_READY,
+    [0x23] = CIA402_STATE_NOT_READY,
+    [0x24] = CIA402_STATE_NOT_READY,
+    [0x25] = CIA402_STATE_NOT_READY,
+    [0x26] = CIA402_STATE_NOT_READY,
+    [0x27] = CIA402_STATE_NOT_READY,
+    [0x28] = CIA402_STATE_NOT_READY,
+    [0x29] = CIA402_STATE_NOT_READY,
+    [0x2A] = CIA402_STATE_NOT_READY,
+    [0x2B] = CIA402_STATE_NOT_READY,
+    [0x2C] = CIA402_STATE_NOT_READY,
+    [0x2D] = CIA402_STATE_NOT_READY,
+    [0x2E] = CIA402_STATE_NOT_READY,
+    [0x2F] = CIA402_STATE_NOT_READY,
+    [0x30] = CIA402_STATE_SWITCH_ON_DISABLED,
+    [0x31] = CIA402_STATE_NOT_READY,
+    [0x32] = CIA402_STATE_NOT_READY,
+    [0x33] = CIA402_STATE_NOT_READY,
+    [0x34] = CIA402_STATE_NOT_READY,
+    [0x35] = CIA402_STATE_NOT_READY,
+    [0x36] = CIA402_STATE_NOT_READY,
+    [0x37] = CIA402_STATE_NOT_READY,
+    [0x38] = CIA402_STATE_NOT_READY,
+    [0x39] = CIA402_STATE_NOT_READY,
+    [0x3A] = CIA402_STATE_NOT_READY,
+    [0x3B] = CIA402_STATE_NOT_READY,
+    [0x3C] = CIA402_STATE_NOT_READY,
+    [0x3D] = CIA402_STATE_NOT_READY,
+    [0x3E] = CIA402_STATE_NOT_READY,
+    [0x3F] = CIA402_STATE_NOT_READY,
+};
+
+static const uint16_t cia402_control_table[CIA402_STATE_COUNT][CIA402_REQ_COUNT] = {
+    /*                       DISABLE ENABLE  HOME    QUICK_STOP */
+    [CIA402_STATE_NOT_READY]          = {0x0000, 0x0000, 0x0000, 0x0000},
+    [CIA402_STATE_SWITCH_ON_DISABLED] = {0x0000, 0x0006, 0x0006, 0x0000},
+    [CIA402_STATE_READY_TO_SWITCH_ON] = {0x0000, 0x0007, 0x0007, 0x0002},
+    [CIA402_STATE_SWITCHED_ON]        = {0x0000, 0x000F, 0x000F, 0x0002},
+    [CIA402_STATE_OPERATION_ENABLED]  = {0x0007, 0x000F, 0x000F, 0x0002},
+    [CIA402_STATE_QUICK_STOP_ACTIVE]  = {0x0000, 0x0000, 0x0000, 0x0002},
+    [CIA402_STATE_FAULT_REACTION_ACTIVE] = {0x0000, 0x0000, 0x0000, 0x0000},
+    [CIA402_STATE_FAULT]              = {0x0000, 0x0000, 0x0000, 0x0000},
+};
+
+uint8_t motion_cia402_decode(uint16_t statusword)
+{
+    if ((statusword & 0x4F) == 0x00) {
+        return CIA402_STATE_NOT_READY;
+    } else if ((statusword & 0x4F) == 0x40) {
+        return CIA402_STATE_SWITCH_ON_DISABLED;
+    } else if ((statusword & 0x6F) == 0x21) {
+        return CIA402_STATE_READY_TO_SWITCH_ON;
+    } else if ((statusword & 0x6F) == 0x23) {
+        return CIA402_STATE_SWITCHED_ON;
+    } else if ((statusword & 0x6F) == 0x27) {
+        return CIA402_STATE_OPERATION_ENABLED;
+    } else if ((statusword & 0x6F) == 0x07) {
+        return CIA402_STATE_QUICK_STOP_ACTIVE;
+    } else if ((statusword & 0x4F) == 0x0F) {
+        return CIA402_STATE_FAULT_REACTION_ACTIVE;
+    } else if ((statusword & 0x4F) == 0x08) {
+        return CIA402_STATE_FAULT;
+    }
+    /* undefined bit patterns are handled like not ready */
+    return CIA402_STATE_NOT_READY;
+}
+
+motion_cia402_t* motion_cia402_create(uint32_t n_axes)
+{
+    motion_cia402_t* engine;
+    uint32_t i;
+
+    if (!n_axes) {
+        MOTION_CONSOLE_ERR(MOTIONCIA402_LOG "no axis given\n");
+        return NULL;
+    }
+    engine = ecat_malloc(sizeof(motion_cia402_t));
+    if (!engine) {
+        MOTION_CONSOLE_ERR(MOTIONCIA402_LOG "engine alloc fail\n");
+        return NULL;
+    }
+    memset(engine, 0, sizeof(motion_cia402_t));
+    engine->axes = ecat_malloc(n_axes * sizeof(motion_cia402_axis_t));
+    if (!engine->axes) {
+        MOTION_CONSOLE_ERR(MOTIONCIA402_LOG "axes alloc fail\n");
+        ecat_free(engine);
+        return NULL;
+    }
+    memset(engine->axes, 0, n_axes * sizeof(motion_cia402_axis_t));
+    engine->n_axes = n_axes;
+    engine->fault_reset_cycles = CIA402_DEFAULT_FAULT_RESET_CYCLES;
+    engine->fault_reset_retries = CIA402_DEFAULT_FAULT_RESET_RETRIES;
+    engine->home_timeout_cycles = CIA402_DEFAULT_HOME_TIMEOUT_CYCLES;
+    for (i = 0; i < n_axes; i++) {
+        engine->axes[i].statusword = DOMAIN_INVAILD_OFFSET;
+        engine->axes[i].controlword = DOMAIN_INVAILD_OFFSET;
+        engine->axes[i].mode = DOMAIN_INVAILD_OFFSET;
+        engine->axes[i].mode_display = DOMAIN_INVAILD_OFFSET;
+        engine->axes[i].op_mode = MODE_CSP;
+        engine->axes[i].retries = engine->fault_reset_retries;
+    }
+    return engine;
+}
+
+void motion_cia402_free(motion_cia402_t* engine)
+{
+    if (!engine) {
+        return;
+    }
+    ecat_free(engine->axes);
+    ecat_free(engine);
+}
+
+int motion_cia402_set_axis(motion_cia402_t* engine, uint32_t axis, uint32_t statusword, uint32_t controlword, uint32_t mode, uint32_t mode_display, int8_t op_mode)
+{
+    motion_cia402_axis_t* a;
+
+    if (!engine || axis >= engine->n_axes) {
+        MOTION_CONSOLE_ERR(MOTIONCIA402_LOG "invalid axis %u\n", axis);
+        return ECAT_FAIL;
+    }
+    if ((statusword == DOMAIN_INVAILD_OFFSET) || (controlword == DOMAIN_INVAILD_OFFSET)) {
+        MOTION_CONSOLE_ERR(MOTIONCIA402_LOG "axis %u needs statusword and controlword\n", axis);
+        return ECAT_FAIL;
+    }
+    a = &engine->axes[axis];
+    a->statusword = statusword;
+    a->controlword = controlword;
+    a->mode = mode;
+    a->mode_display = mode_display;
+    a->op_mode = op_mode;
+    return ECAT_OKAY;
+}
+
+int motion_cia402_register_axis(motion_cia402_t* engine, uint32_t axis, servo_master_t* master, uint16_t alias, uint16_t position, int8_t op_mode)
+{
+    if (!master) {
+        MOTION_CONSOLE_ERR(MOTIONCIA402_LOG "no master is created\n");
+        return ECAT_FAIL;
+    }
+    if (master->domain_mode) {
+        MOTION_CONSOLE_ERR(MOTIONCIA402_LOG "axes need a single domain, use motion_cia402_set_axis()\n");
+        return ECAT_FAIL;
+    }
+    return motion_cia402_set_axis(engine, axis,
+        motion_servo_get_domain_offset(master, alias, position, 0x6041, 0x00),
+        motion_servo_get_domain_offset(master, alias, position, 0x6040, 0x00),
+        motion_servo_get_domain_offset(master, alias, position, 0x6060, 0x00),
+        motion_servo_get_domain_offset(master, alias, position, 0x6061, 0x00),
+        op_mode);
+}
+
+int motion_cia402_request(motion_cia402_t* engine, uint32_t axis, uint8_t request)
+{
+    motion_cia402_axis_t* a;
+
+    if (!engine || axis >= engine->n_axes || request >= CIA402_REQ_COUNT) {
+        MOTION_CONSOLE_ERR(MOTIONCIA402_LOG "invalid request %u for axis %u\n", request, axis);
+        return ECAT_FAIL;
+    }
+    a = &engine->axes[axis];
+    if ((request == a->request) && !(a->flags & CIA402_FLAG_FAULT)) {
+        return ECAT_OKAY;
+    }
+    a->request = request;
+    a->home_step = HOME_IDLE;
+    /* requesting again also retries a drive whose resets were used up */
+    a->flags &= ~CIA402_FLAG_FAULT;
+    a->retries = engine->fault_reset_retries;
+    return ECAT_OKAY;
+}
+
+int motion_cia402_request_all(motion_cia402_t* engine, uint8_t request)
+{
+    uint32_t i;
+
+    if (!engine) {
+        return ECAT_FAIL;
+    }
+    for (i = 0; i < engine->n_axes; i++) {
+        if (motion_cia402_request(engine, i, request)) {
+            return ECAT_FAIL;
+        }
+    }
+    return ECAT_OKAY;
+}
+
+/* Fault reset: a rising edge of the reset bit, held for a number of cycles */
+static uint16_t motion_cia402_fault_step(motion_cia402_t* engine, motion_cia402_axis_t* a)
+{
+    if (a->state == CIA402_STATE_FAULT_REACTION_ACTIVE) {
+        return 0x0000;
+    }
+    if (a->reset_step == RESET_HIGH) {
+        if (++a->timer < engine->fault_reset_cycles) {
+            return CIA402_CW_FAULT_RESET;
+        }
+        a->reset_step = RESET_IDLE;
+        return 0x0000;
+    }
+    if ((a->request == CIA402_REQ_DISABLE) || (a->flags & CIA402_FLAG_FAULT)) {
+        return 0x0000;
+    }
+    if (!a->retries) {
+        a->flags |= CIA402_FLAG_FAULT;
+        MOTION_CONSOLE_ERR(MOTIONCIA402_LOG "axis fault persists after %u resets\n",
+            engine->fault_reset_retries);
+        return 0x0000;
+    }
+    /* the previous controlword had the reset bit clear */
+    a->retries--;
+    a->reset_step = RESET_HIGH;
+    a->timer = 0;
+    return CIA402_CW_FAULT_RESET;
+}
+
+/* Homing in MODE_HM, ends with the request switched to enable or disable */
+static uint16_t motion_cia402_home_step(motion_cia402_t* engine, motion_cia402_axis_t* a, const uint8_t* in_pd)
+{
+    uint16_t status = a->status;
+
+    switch (a->home_step) {
+    case HOME_IDLE:
+        a->flags &= ~(CIA402_FLAG_HOMED | CIA402_FLAG_HOME_ERROR);
+        a->home_step = HOME_ENABLE;
+        /* fall through */
+    case HOME_ENABLE:
+        if ((a->state == CIA402_STATE_OPERATION_ENABLED) &&
+            ((a->mode_display == DOMAIN_INVAILD_OFFSET) ||
+             (MOTION_DOMAIN_READ_S8(in_pd + a->mode_display) == MODE_HM))) {
+            a->home_step = HOME_START;
+            a->timer = 0;
+            return 0x000F | CIA402_CW_HOMING_START;
+        }
+        return cia402_control_table[a->state][CIA402_REQ_HOME];
+    default:
+        break;
+    }
+
+    if (a->state != CIA402_STATE_OPERATION_ENABLED) {
+        a->home_step = HOME_ENABLE;
+        return cia402_control_table[a->state][CIA402_REQ_HOME];
+    }
+    a->timer++;
+    if ((status & CIA402_SW_HOMING_ERROR) ||
+        (engine->home_timeout_cycles && a->timer >= engine->home_timeout_cycles)) {
+        MOTION_CONSOLE_ERR(MOTIONCIA402_LOG "homing %s\n",
+            (status & CIA402_SW_HOMING_ERROR) ? "error" : "timeout");
+        a->flags |= CIA402_FLAG_HOME_ERROR;
+        a->request = CIA402_REQ_DISABLE;
+        a->home_step = HOME_IDLE;
+        return cia402_control_table[a->state][CIA402_REQ_DISABLE];
+    }
+    if (!(status & CIA402_SW_HOMING_ATTAINED)) {
+        a->home_step = HOME_RUN;
+    } else if ((status & CIA402_SW_TARGET_REACHED) &&
+        ((a->home_step == HOME_RUN) || (a->timer >= CIA402_HOME_SETTLE_CYCLES))) {
+        a->flags |= CIA402_FLAG_HOMED;
+        a->request = CIA402_REQ_ENABLE;
+        a->home_step = HOME_IDLE;
+        return 0x000F;
+    }
+    return 0x000F | CIA402_CW_HOMING_START;
+}
+
+void motion_cia402_step(motion_cia402_t* engine, const uint8_t* in_pd, uint8_t* out_pd)
+{
+    motion_cia402_axis_t* a = engine->axes;
+    motion_cia402_axis_t* end = a + engine->n_axes;
+    uint32_t n_enabled = 0, n_faulted = 0;
+    uint16_t control;
+
+    for (; a < end; a++) {
+        if (a->statusword == DOMAIN_INVAILD_OFFSET) {
+            continue;
+        }
+        a->status = MOTION_DOMAIN_READ_U16(in_pd + a->statusword);
+        a->state = cia402_state_table[CIA402_SW_INDEX(a->status)];
+
+        a->flags &= ~CIA402_FLAG_READY;
+        if (a->state >= CIA402_STATE_FAULT_REACTION_ACTIVE) {
+            control = motion_cia402_fault_step(engine, a);
+            n_faulted++;
+        } else {
+            a->reset_step = RESET_IDLE;
+            if (a->request == CIA402_REQ_HOME) {
+                control = motion_cia402_home_step(engine, a, in_pd);
+            } else {
+                control = cia402_control_table[a->state][a->request];
+                if (a->state == CIA402_STATE_OPERATION_ENABLED) {
+                    a->retries = engine->fault_reset_retries;
+                    if ((a->request == CIA402_REQ_ENABLE) &&
+                        ((a->mode_display == DOMAIN_INVAILD_OFFSET) ||
+                         (MOTION_DOMAIN_READ_S8(in_pd + a->mode_display) == a->op_mode))) {
+                        a->flags |= CIA402_FLAG_READY;
+                        n_enabled++;
+                    }
+                }
+            }
+        }
+
+        a->control = control;
+        MOTION_DOMAIN_WRITE_U16(out_pd + a->controlword, control);
+        if (a->mode != DOMAIN_INVAILD_OFFSET) {
+            MOTION_DOMAIN_WRITE_S8(out_pd + a->mode,
+                a->request == CIA402_REQ_HOME ? MODE_HM : a->op_mode);
+        }
+    }
+    engine->n_enabled = n_enabled;
+    engine->n_faulted = n_faulted;
+}
@@ -0,0 +1,123 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2025 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions
+// and limitations under the License.
+
+/**
+ *
+ * @file motioncia402.h
+ *
+ * CiA402 drive state machine for all axes of a master. One call per cycle
+ * decodes the statuswords of every axis from the process image and writes
+ * the controlwords and modes of operation, including fault reset and
+ * homing.
+ *
+ */
+
+#ifndef __MOTION_CIA402_H__
+#define __MOTION_CIA402_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "motionentry.h"
+
+/* Drive states decoded from the statusword */
+enum{
+    CIA402_STATE_NOT_READY = 0,
+    CIA402_STATE_SWITCH_ON_DISABLED,
+    CIA402_STATE_READY_TO_SWITCH_ON,
+    CIA402_STATE_SWITCHED_ON,
+    CIA402_STATE_OPERATION_ENABLED,
+    CIA402_STATE_QUICK_STOP_ACTIVE,
+    CIA402_STATE_FAULT_REACTION_ACTIVE,
+    CIA402_STATE_FAULT,
+    CIA402_STATE_COUNT
+};
+
+/* Requested axis behaviour */
+enum{
+    CIA402_REQ_DISABLE = 0,  /**< Switch on disabled. */
+    CIA402_REQ_ENABLE,       /**< Operation enabled in the axis mode. */
+    CIA402_REQ_HOME,         /**< Home in MODE_HM, then enable. */
+    CIA402_REQ_QUICK_STOP,   /**< Quick stop and hold. */
+    CIA402_REQ_COUNT
+};
+
+/* Axis flags */
+#define CIA402_FLAG_HOMED       (0x01)  /**< Homing attained. */
+#define CIA402_FLAG_HOME_ERROR  (0x02)  /**< Homing error or timeout. */
+#define CIA402_FLAG_FAULT       (0x04)  /**< Fault reset retries used up. */
+#define CIA402_FLAG_READY       (0x08)  /**< Enabled in the axis mode. */
+
+#define CIA402_DEFAULT_FAULT_RESET_CYCLES   (10)
+#define CIA402_DEFAULT_FAULT_RESET_RETRIES  (3)
+#define CIA402_DEFAULT_HOME_TIMEOUT_CYCLES  (60000)
+
+/* Statusword bits used by the engine */
+#define CIA402_SW_TARGET_REACHED    (0x0400)
+#define CIA402_SW_HOMING_ATTAINED   (0x1000)
+#define CIA402_SW_HOMING_ERROR      (0x2000)
+
+/* Controlword bits set by the engine */
+#define CIA402_CW_HOMING_START      (0x0010)
+#define CIA402_CW_FAULT_RESET       (0x0080)
+
+typedef struct{
+    uint32_t statusword;    /**< Offset of 0x6041 in the input image. */
+    uint32_t controlword;   /**< Offset of 0x6040 in the output image. */
+    uint32_t mode;          /**< Offset of 0x6060, or DOMAIN_INVAILD_OFFSET. */
+    uint32_t mode_display;  /**< Offset of 0x6061, or DOMAIN_INVAILD_OFFSET. */
+    uint32_t timer;         /**< Cycles in the current reset or homing step. */
+    uint16_t status;        /**< Last statusword. */
+    uint16_t control;       /**< Last controlword. */
+    uint8_t state;          /**< Decoded drive state. */
+    uint8_t request;        /**< CIA402_REQ_* */
+    int8_t op_mode;         /**< Mode of operation when enabled. */
+    uint8_t home_step;      /**< Homing sequence step. */
+    uint8_t reset_step;     /**< Fault reset sequence step. */
+    uint8_t retries;        /**< Fault resets left. */
+    uint8_t flags;          /**< CIA402_FLAG_* */
+    uint8_t reserved;
+} motion_cia402_axis_t;
+
+typedef struct{
+    motion_cia402_axis_t* axes;
+    uint32_t n_axes;
+    uint32_t n_enabled;     /**< Ready axes after the last step. */
+    uint32_t n_faulted;     /**< Axes in fault after the last step. */
+    uint32_t fault_reset_cycles;    /**< Cycles the reset bit is held. */
+    uint32_t home_timeout_cycles;   /**< Homing limit, 0 for none. */
+    uint8_t fault_reset_retries;    /**< Resets tried before giving up. */
+} motion_cia402_t;
+
+motion_cia402_t* motion_cia402_create(uint32_t n_axes);
+void motion_cia402_free(motion_cia402_t* engine);
+int motion_cia402_set_axis(motion_cia402_t* engine, uint32_t axis, uint32_t statusword, uint32_t controlword, uint32_t mode, uint32_t mode_display, int8_t op_mode);
+int motion_cia402_register_axis(motion_cia402_t* engine, uint32_t axis, servo_master_t* master, uint16_t alias, uint16_t position, int8_t op_mode);
+int motion_cia402_request(motion_cia402_t* engine, uint32_t axis, uint8_t request);
+int motion_cia402_request_all(motion_cia402_t* engine, uint8_t request);
+void motion_cia402_step(motion_cia402_t* engine, const uint8_t* in_pd, uint8_t* out_pd);
+uint8_t motion_cia402_decode(uint16_t statusword);
+
+static inline int motion_cia402_axis_ready(const motion_cia402_t* engine, uint32_t axis)
+{
+    return engine->axes[axis].flags & CIA402_FLAG_READY;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
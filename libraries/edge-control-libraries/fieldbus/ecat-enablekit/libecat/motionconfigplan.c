@@ -0,0 +1,536 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2025 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions
+// and limitations under the License.
+
+/**
+ *
+ * @file motionconfigplan.c
+ *
+ * The plan runs on a pool of workers. A worker takes the first pending
+ * slave whose dependencies are done and sends its steps one after the
+ * other, so the mailbox of a slave never sees two requests at once while
+ * the round trips of different slaves overlap.
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "motionconfigplan.h"
+#include "motionentry.h"
+#include "debug.h"
+#include "common.h"
+#include "../eniconfig/eniconfig.h"
+
+#define MOTIONCONFIGPLAN_LOG "MOTION_CONFIG_PLAN: "
+
+typedef struct{
+    motion_config_plan_t* plan;
+    const motion_config_transport_t* transport;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    uint32_t running;
+} config_plan_run_t;
+
+static int64_t config_plan_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)TIMESPEC2NS(ts);
+}
+
+motion_config_plan_t* motion_config_plan_create(void)
+{
+    motion_config_plan_t* plan;
+    plan = (motion_config_plan_t*)ecat_malloc(sizeof(motion_config_plan_t));
+    if (!plan) {
+        MOTION_CONSOLE_ERR(MOTIONCONFIGPLAN_LOG "Failed to malloc for plan\n");
+        return NULL;
+    }
+    memset(plan, 0, sizeof(motion_config_plan_t));
+    return plan;
+}
+
+void motion_config_plan_free(motion_config_plan_t* plan)
+{
+    uint32_t i, j;
+    if (!plan) {
+        return;
+    }
+    for (i = 0; i < plan->n_slaves; i++) {
+        motion_config_slave_t* slave = &plan->slaves[i];
+        for (j = 0; j < slave->n_steps; j++) {
+            if (slave->steps[j].data) {
+                ecat_free(slave->steps[j].data);
+            }
+        }
+        if (slave->steps) {
+            ecat_free(slave->steps);
+        }
+        if (slave->after) {
+            ecat_free(slave->after);
+        }
+    }
+    if (plan->slaves) {
+        ecat_free(plan->slaves);
+    }
+    ecat_free(plan);
+}
+
+/* Grow an array of count elements to hold one more */
+static int config_plan_reserve(void** array, uint32_t* capacity, uint32_t count, size_t size)
+{
+    uint32_t n;
+    void* grown;
+    if (count < *capacity) {
+        return ECAT_OKAY;
+    }
+    n = *capacity ? *capacity * 2 : 8;
+    grown = ecat_malloc(size*n);
+    if (!grown) {
+        return ECAT_FAIL;
+    }
+    memset(grown, 0, size*n);
+    if (*array) {
+        memcpy(grown, *array, size*count);
+        ecat_free(*array);
+    }
+    *array = grown;
+    *capacity = n;
+    return ECAT_OKAY;
+}
+
+motion_config_slave_t* motion_config_plan_get_slave(motion_config_plan_t* plan, uint16_t position)
+{
+    uint32_t i;
+    if (!plan) {
+        return NULL;
+    }
+    for (i = 0; i < plan->n_slaves; i++) {
+        if (plan->slaves[i].position == position) {
+            return &plan->slaves[i];
+        }
+    }
+    return NULL;
+}
+
+motion_config_slave_t* motion_config_plan_add_slave(motion_config_plan_t* plan, uint16_t position, uint32_t vendor_id, uint32_t product_code)
+{
+    motion_config_slave_t* slave;
+    if (!plan) {
+        return NULL;
+    }
+    slave = motion_config_plan_get_slave(plan, position);
+    if (slave) {
+        if (vendor_id||product_code) {
+            slave->vendor_id = vendor_id;
+            slave->product_code = product_code;
+        }
+        return slave;
+    }
+    if (config_plan_reserve((void**)&plan->slaves, &plan->slaves_capacity, plan->n_slaves, sizeof(motion_config_slave_t))) {
+        MOTION_CONSOLE_ERR(MOTIONCONFIGPLAN_LOG "Failed to malloc for slaves\n");
+        return NULL;
+    }
+    slave = &plan->slaves[plan->n_slaves++];
+    memset(slave, 0, sizeof(motion_config_slave_t));
+    slave->position = position;
+    slave->vendor_id = vendor_id;
+    slave->product_code = product_code;
+    return slave;
+}
+
+int motion_config_plan_add_step(motion_config_plan_t* plan, uint16_t position, const motion_config_step_t* step)
+{
+    motion_config_slave_t* slave;
+    motion_config_step_t* dst;
+    if ((!plan)||(!step)||((step->size)&&(!step->data))) {
+        return ECAT_FAIL;
+    }
+    if ((step->type == CONFIG_STEP_SDO_UPLOAD)&&(step->size > CONFIG_PLAN_MAX_UPLOAD)) {
+        MOTION_CONSOLE_ERR(MOTIONCONFIGPLAN_LOG "Upload of %u bytes is too large\n", step->size);
+        return ECAT_FAIL;
+    }
+    slave = motion_config_plan_add_slave(plan, position, 0, 0);
+    if (!slave) {
+        return ECAT_FAIL;
+    }
+    if (config_plan_reserve((void**)&slave->steps, &slave->steps_capacity, slave->n_steps, sizeof(motion_config_step_t))) {
+        MOTION_CONSOLE_ERR(MOTIONCONFIGPLAN_LOG "Failed to malloc for steps\n");
+        return ECAT_FAIL;
+    }
+    dst = &slave->steps[slave->n_steps];
+    *dst = *step;
+    dst->data = NULL;
+    if (step->size) {
+        dst->data = (uint8_t*)ecat_malloc(step->size);
+        if (!dst->data) {
+            MOTION_CONSOLE_ERR(MOTIONCONFIGPLAN_LOG "Failed to malloc for step data\n");
+            return ECAT_FAIL;
+        }
+        memcpy(dst->data, step->data, step->size);
+    }
+    slave->n_steps++;
+    return ECAT_OKAY;
+}
+
+int motion_config_plan_add_sdo(motion_config_plan_t* plan, uint16_t position, uint16_t index, uint8_t subindex, const void* data, uint32_t size)
+{
+    motion_config_step_t step;
+    memset(&step, 0, sizeof(step));
+    step.type = CONFIG_STEP_SDO_DOWNLOAD;
+    step.index = index;
+    step.subindex = subindex;
+    step.data = (uint8_t*)data;
+    step.size = size;
+    return motion_config_plan_add_step(plan, position, &step);
+}
+
+int motion_config_plan_add_dependency(motion_config_plan_t* plan, uint16_t position, uint16_t after)
+{
+    motion_config_slave_t* slave;
+    uint32_t i;
+    if ((!plan)||(position == after)) {
+        return ECAT_FAIL;
+    }
+    slave = motion_config_plan_add_slave(plan, position, 0, 0);
+    if (!slave) {
+        return ECAT_FAIL;
+    }
+    for (i = 0; i < slave->n_after; i++) {
+        if (slave->after[i] == after) {
+            return ECAT_OKAY;
+        }
+    }
+    if (config_plan_reserve((void**)&slave->after, &slave->after_capacity, slave->n_after, sizeof(uint16_t))) {
+        MOTION_CONSOLE_ERR(MOTIONCONFIGPLAN_LOG "Failed to malloc for dependencies\n");
+        return ECAT_FAIL;
+    }
+    slave->after[slave->n_after++] = after;
+    return ECAT_OKAY;
+}
+
+int motion_config_plan_load_eni(motion_config_plan_t* plan, void* eni_info, uint16_t transitions)
+{
+    eni_config* info = (eni_config*)eni_info;
+    eni_config_slave* eni_slave = NULL;
+    if ((!plan)||(!info)) {
+        return ECAT_FAIL;
+    }
+    list_for_each_entry(eni_slave, &info->slave_list, list) {
+        uint16_t position = eni_slave->info.physAddr - SLAVE_PHYS_ADDR_OFFSET;
+        eni_slave_mailbox* mailbox = eni_slave->mailbox;
+        motion_config_step_t step;
+        if (!motion_config_plan_add_slave(plan, position, eni_slave->info.vendorId, eni_slave->info.productCode)) {
+            return ECAT_FAIL;
+        }
+        if (!mailbox) {
+            continue;
+        }
+        if ((mailbox->protocol & PROTOCOL_MAILBOX_COE)&&(mailbox->coe)) {
+            eni_slave_mailbox_coe_initcmd* cmd = NULL;
+            list_for_each_entry(cmd, &mailbox->coe->initcmds_list, list) {
+                if ((cmd->disabled)||(!(cmd->transition.type & transitions))) {
+                    continue;
+                }
+                memset(&step, 0, sizeof(step));
+                if (cmd->ccs == ENI_SLAVE_MAILBOX_CCS_DOWNLOAD_TYPE) {
+                    step.type = CONFIG_STEP_SDO_DOWNLOAD;
+                } else if (cmd->ccs == ENI_SLAVE_MAILBOX_CCS_UPLOAD_TYPE) {
+                    step.type = CONFIG_STEP_SDO_UPLOAD;
+                } else {
+                    MOTION_CONSOLE_WARN(MOTIONCONFIGPLAN_LOG "Slave %u: skip InitCmd 0x%04x:%02x with Ccs %u\n",
+                        position, cmd->index, cmd->subindex, cmd->ccs);
+                    continue;
+                }
+                step.transition = cmd->transition.type;
+                step.index = cmd->index;
+                step.subindex = cmd->subindex;
+                step.data = (uint8_t*)cmd->data;
+                step.size = cmd->data ? cmd->data_size : 0;
+                if (motion_config_plan_add_step(plan, position, &step)) {
+                    return ECAT_FAIL;
+                }
+            }
+        }
+        if ((mailbox->protocol & PROTOCOL_MAILBOX_SOE)&&(mailbox->soe)) {
+            eni_slave_mailbox_soe_initcmd* cmd = NULL;
+            list_for_each_entry(cmd, &mailbox->soe->initcmds_list, list) {
+                if ((cmd->disabled)||(!(cmd->transition.type & transitions))) {
+                    continue;
+                }
+                memset(&step, 0, sizeof(step));
+                step.type = CONFIG_STEP_IDN_WRITE;
+                step.transition = cmd->transition.type;
+                step.index = cmd->idn;
+                step.subindex = cmd->driveno;
+                step.data = cmd->data;
+                step.size = cmd->data ? cmd->data_size : 0;
+                if (motion_config_plan_add_step(plan, position, &step)) {
+                    return ECAT_FAIL;
+                }
+            }
+        }
+    }
+    return ECAT_OKAY;
+}
+
+static int config_plan_run_step(const motion_config_transport_t* transport, motion_config_slave_t* slave, const motion_config_step_t* step)
+{
+    uint8_t upload[CONFIG_PLAN_MAX_UPLOAD];
+    size_t result_size = 0;
+    uint32_t abort_code = 0;
+    uint16_t error_code = 0;
+    int ret = ECAT_FAIL;
+
+    switch (step->type) {
+    case CONFIG_STEP_SDO_DOWNLOAD:
+        if (transport->sdo_download) {
+            ret = transport->sdo_download(transport->ctx, slave->position, step->index, step->subindex,
+                step->data, step->size, &abort_code);
+        }
+        break;
+    case CONFIG_STEP_SDO_UPLOAD:
+        if (transport->sdo_upload) {
+            ret = transport->sdo_upload(transport->ctx, slave->position, step->index, step->subindex,
+                upload, sizeof(upload), &result_size, &abort_code);
+        }
+        if ((ret == 0)&&(step->size)&&((result_size < step->size)||(memcmp(upload, step->data, step->size)))) {
+            slave->error = CONFIG_ERROR_MISMATCH;
+            return ECAT_FAIL;
+        }
+        break;
+    case CONFIG_STEP_IDN_WRITE:
+        if (transport->idn_write) {
+            ret = transport->idn_write(transport->ctx, slave->position, step->subindex, step->index,
+                step->data, step->size, &error_code);
+        }
+        abort_code = error_code;
+        break;
+    default:
+        break;
+    }
+    if (ret) {
+        slave->error = CONFIG_ERROR_TRANSFER;
+        slave->abort_code = abort_code;
+        return ECAT_FAIL;
+    }
+    return ECAT_OKAY;
+}
+
+/* Runs the steps of a slave without the lock, returns its final state */
+static uint8_t config_plan_run_slave(const motion_config_transport_t* transport, motion_config_slave_t* slave)
+{
+    uint8_t state = CONFIG_SLAVE_DONE;
+    uint32_t i;
+    slave->start_ns = config_plan_now();
+    for (i = 0; i < slave->n_steps; i++) {
+        if (config_plan_run_step(transport, slave, &slave->steps[i])) {
+            const motion_config_step_t* step = &slave->steps[i];
+            state = CONFIG_SLAVE_FAILED;
+            slave->failed_step = i;
+            if (slave->error == CONFIG_ERROR_MISMATCH) {
+                MOTION_CONSOLE_ERR(MOTIONCONFIGPLAN_LOG "Slave %u: step %u, 0x%04x:%02x differs from the expected value\n",
+                    slave->position, i, step->index, step->subindex);
+            } else {
+                MOTION_CONSOLE_ERR(MOTIONCONFIGPLAN_LOG "Slave %u: step %u, 0x%04x:%02x failed, abort code 0x%08x\n",
+                    slave->position, i, step->index, step->subindex, slave->abort_code);
+            }
+            break;
+        }
+    }
+    slave->end_ns = config_plan_now();
+    return state;
+}
+
+/* Pick the next slave to configure, called with the lock held. Returns
+ * NULL if nothing is ready; sets *finished if nothing ever will be. */
+static motion_config_slave_t* config_plan_next(config_plan_run_t* run, int* finished)
+{
+    motion_config_plan_t* plan = run->plan;
+    uint32_t i, j;
+    int pending = 0;
+    int changed;
+
+    *finished = 0;
+    do {
+        changed = 0;
+        pending = 0;
+        for (i = 0; i < plan->n_slaves; i++) {
+            motion_config_slave_t* slave = &plan->slaves[i];
+            int ready = 1;
+            if (slave->state != CONFIG_SLAVE_PENDING) {
+                continue;
+            }
+            for (j = 0; j < slave->n_after; j++) {
+                motion_config_slave_t* dep = motion_config_plan_get_slave(plan, slave->after[j]);
+                if (!dep) {
+                    continue;
+                }
+                if ((dep->state == CONFIG_SLAVE_FAILED)||(dep->state == CONFIG_SLAVE_BLOCKED)) {
+                    slave->state = CONFIG_SLAVE_BLOCKED;
+                    slave->error = CONFIG_ERROR_DEPENDENCY;
+                    plan->n_blocked++;
+                    MOTION_CONSOLE_ERR(MOTIONCONFIGPLAN_LOG "Slave %u: not configured, slave %u failed\n",
+                        slave->position, dep->position);
+                    changed = 1;
+                    ready = 0;
+                    break;
+                }
+                if (dep->state != CONFIG_SLAVE_DONE) {
+                    ready = 0;
+                }
+            }
+            if (slave->state != CONFIG_SLAVE_PENDING) {
+                continue;
+            }
+            if (ready) {
+                slave->state = CONFIG_SLAVE_RUNNING;
+                return slave;
+            }
+            pending++;
+        }
+    } while (changed);
+
+    if ((pending)&&(!run->running)) {
+        /* Nothing runs that could release them: circular dependencies */
+        for (i = 0; i < plan->n_slaves; i++) {
+            motion_config_slave_t* slave = &plan->slaves[i];
+            if (slave->state == CONFIG_SLAVE_PENDING) {
+                slave->state = CONFIG_SLAVE_BLOCKED;
+                slave->error = CONFIG_ERROR_DEPENDENCY;
+                plan->n_blocked++;
+                MOTION_CONSOLE_ERR(MOTIONCONFIGPLAN_LOG "Slave %u: not configured, circular dependency\n",
+                    slave->position);
+            }
+        }
+        pending = 0;
+    }
+    *finished = !pending;
+    return NULL;
+}
+
+static void* config_plan_worker(void* arg)
+{
+    config_plan_run_t* run = (config_plan_run_t*)arg;
+    motion_config_plan_t* plan = run->plan;
+
+    pthread_mutex_lock(&run->lock);
+    while (1) {
+        int finished;
+        uint8_t state;
+        motion_config_slave_t* slave = config_plan_next(run, &finished);
+        if (!slave) {
+            if (finished) {
+                break;
+            }
+            pthread_cond_wait(&run->cond, &run->lock);
+            continue;
+        }
+        run->running++;
+        if (run->running > plan->max_in_flight) {
+            plan->max_in_flight = run->running;
+        }
+        pthread_mutex_unlock(&run->lock);
+
+        state = config_plan_run_slave(run->transport, slave);
+
+        pthread_mutex_lock(&run->lock);
+        slave->state = state;
+        run->running--;
+        if (slave->state == CONFIG_SLAVE_DONE) {
+            plan->n_done++;
+        } else {
+            plan->n_failed++;
+        }
+        pthread_cond_broadcast(&run->cond);
+    }
+    /* Wake the others to let them see the end */
+    pthread_cond_broadcast(&run->cond);
+    pthread_mutex_unlock(&run->lock);
+    return NULL;
+}
+
+int motion_config_plan_execute(motion_config_plan_t* plan, const motion_config_transport_t* transport, uint32_t max_parallel)
+{
+    config_plan_run_t run;
+    pthread_t* threads = NULL;
+    uint32_t n_threads = 0;
+    uint32_t i;
+    int64_t start;
+
+    if ((!plan)||(!transport)) {
+        return ECAT_FAIL;
+    }
+    if (!max_parallel) {
+        max_parallel = CONFIG_PLAN_DEFAULT_PARALLEL;
+    }
+    if (max_parallel > plan->n_slaves) {
+        max_parallel = plan->n_slaves;
+    }
+    for (i = 0; i < plan->n_slaves; i++) {
+        motion_config_slave_t* slave = &plan->slaves[i];
+        slave->state = CONFIG_SLAVE_PENDING;
+        slave->error = CONFIG_ERROR_NONE;
+        slave->failed_step = 0;
+        slave->abort_code = 0;
+        slave->start_ns = 0;
+        slave->end_ns = 0;
+    }
+    plan->n_done = 0;
+    plan->n_failed = 0;
+    plan->n_blocked = 0;
+    plan->max_in_flight = 0;
+
+    memset(&run, 0, sizeof(run));
+    run.plan = plan;
+    run.transport = transport;
+    pthread_mutex_init(&run.lock, NULL);
+    pthread_cond_init(&run.cond, NULL);
+
+    start = config_plan_now();
+    /* The caller is one of the workers */
+    if (max_parallel > 1) {
+        threads = (pthread_t*)ecat_malloc(sizeof(pthread_t)*(max_parallel - 1));
+        if (!threads) {
+            MOTION_CONSOLE_WARN(MOTIONCONFIGPLAN_LOG "Failed to malloc for workers, configure one slave at a time\n");
+        }
+    }
+    for (i = 0; (threads)&&(i < max_parallel - 1); i++) {
+        if (pthread_create(&threads[i], NULL, config_plan_worker, &run)) {
+            MOTION_CONSOLE_WARN(MOTIONCONFIGPLAN_LOG "Failed to start worker %u\n", i + 1);
+            break;
+        }
+        n_threads++;
+    }
+    config_plan_worker(&run);
+    for (i = 0; i < n_threads; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    plan->elapsed_ns = config_plan_now() - start;
+    if (threads) {
+        ecat_free(threads);
+    }
+    pthread_cond_destroy(&run.cond);
+    pthread_mutex_destroy(&run.lock);
+
+    if (plan->n_done != plan->n_slaves) {
+        MOTION_CONSOLE_ERR(MOTIONCONFIGPLAN_LOG "%u of %u slaves configured, %u failed, %u blocked\n",
+            plan->n_done, plan->n_slaves, plan->n_failed, plan->n_blocked);
+        return ECAT_FAIL;
+    }
+    return ECAT_OKAY;
+}
@@ -0,0 +1,144 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2025 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions
+// and limitations under the License.
+
+/**
+ *
+ * @file motionconfigplan.h
+ *
+ * Slave configuration plan. Collects the mailbox transfers of the bring-up
+ * per slave, from the CoE and SoE InitCmds of the ENI or added by the
+ * application, and runs them with one transfer in flight per slave and
+ * several slaves in parallel. The steps of a slave keep their order, a
+ * slave waits for the slaves it depends on. Each slave reports its own
+ * result.
+ *
+ */
+
+#ifndef __MOTION_CONFIG_PLAN_H__
+#define __MOTION_CONFIG_PLAN_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Step type */
+enum{
+    CONFIG_STEP_SDO_DOWNLOAD = 0,
+    CONFIG_STEP_SDO_UPLOAD,     /**< Read back and compare with the data. */
+    CONFIG_STEP_IDN_WRITE
+};
+
+/* Slave state */
+enum{
+    CONFIG_SLAVE_PENDING = 0,
+    CONFIG_SLAVE_RUNNING,
+    CONFIG_SLAVE_DONE,
+    CONFIG_SLAVE_FAILED,
+    CONFIG_SLAVE_BLOCKED        /**< A dependency failed or is circular. */
+};
+
+/* Reason of a failed slave */
+enum{
+    CONFIG_ERROR_NONE = 0,
+    CONFIG_ERROR_TRANSFER,      /**< Transfer failed, see abort_code. */
+    CONFIG_ERROR_MISMATCH,      /**< Upload differs from the expected data. */
+    CONFIG_ERROR_DEPENDENCY
+};
+
+#define CONFIG_PLAN_DEFAULT_PARALLEL    (16)
+#define CONFIG_PLAN_MAX_UPLOAD          (64)
+
+typedef struct{
+    uint8_t type;           /**< CONFIG_STEP_* */
+    uint16_t transition;    /**< ENI_TRANSITION_* of the InitCmd, 0 if added. */
+    uint16_t index;         /**< SDO index or IDN. */
+    uint8_t subindex;       /**< SDO subindex or drive number. */
+    uint8_t* data;
+    uint32_t size;
+} motion_config_step_t;
+
+typedef struct{
+    uint16_t position;
+    uint32_t vendor_id;
+    uint32_t product_code;
+    motion_config_step_t* steps;
+    uint32_t n_steps;
+    uint32_t steps_capacity;
+    uint16_t* after;        /**< Positions of the slaves to finish first. */
+    uint32_t n_after;
+    uint32_t after_capacity;
+    /* result */
+    uint8_t state;          /**< CONFIG_SLAVE_* */
+    uint8_t error;          /**< CONFIG_ERROR_* */
+    uint32_t failed_step;
+    uint32_t abort_code;    /**< CoE abort code or SoE error code. */
+    int64_t start_ns;
+    int64_t end_ns;
+} motion_config_slave_t;
+
+/* Blocking mailbox transfers, return 0 on success. Called from several
+ * threads at once, never twice at once for the same slave. */
+typedef struct{
+    int (*sdo_download)(void* ctx, uint16_t position, uint16_t index, uint8_t subindex,
+            const uint8_t* data, size_t size, uint32_t* abort_code);
+    int (*sdo_upload)(void* ctx, uint16_t position, uint16_t index, uint8_t subindex,
+            uint8_t* data, size_t size, size_t* result_size, uint32_t* abort_code);
+    int (*idn_write)(void* ctx, uint16_t position, uint8_t drive_no, uint16_t idn,
+            const uint8_t* data, size_t size, uint16_t* error_code);
+    void* ctx;
+} motion_config_transport_t;
+
+typedef struct{
+    motion_config_slave_t* slaves;
+    uint32_t n_slaves;
+    uint32_t slaves_capacity;
+    uint32_t n_done;
+    uint32_t n_failed;
+    uint32_t n_blocked;
+    uint32_t max_in_flight; /**< Most slaves configured at once. */
+    int64_t elapsed_ns;
+} motion_config_plan_t;
+
+motion_config_plan_t* motion_config_plan_create(void);
+void motion_config_plan_free(motion_config_plan_t* plan);
+motion_config_slave_t* motion_config_plan_add_slave(motion_config_plan_t* plan, uint16_t position, uint32_t vendor_id, uint32_t product_code);
+motion_config_slave_t* motion_config_plan_get_slave(motion_config_plan_t* plan, uint16_t position);
+int motion_config_plan_add_step(motion_config_plan_t* plan, uint16_t position, const motion_config_step_t* step);
+int motion_config_plan_add_sdo(motion_config_plan_t* plan, uint16_t position, uint16_t index, uint8_t subindex, const void* data, uint32_t size);
+int motion_config_plan_add_dependency(motion_config_plan_t* plan, uint16_t position, uint16_t after);
+
+/**
+ * @brief Add the enabled CoE and SoE InitCmds of the ENI slaves.
+ * @param plan The plan.
+ * @param eni_info ENI information, eni_config*.
+ * @param transitions ENI_TRANSITION_* mask of the InitCmds to add.
+ * @return ECAT_OKAY, ECAT_FAIL on allocation failure.
+ */
+int motion_config_plan_load_eni(motion_config_plan_t* plan, void* eni_info, uint16_t transitions);
+
+/**
+ * @brief Run the plan, at most max_parallel slaves at once.
+ * @return ECAT_OKAY if every slave is configured, ECAT_FAIL otherwise.
+ */
+int motion_config_plan_execute(motion_config_plan_t* plan, const motion_config_transport_t* transport, uint32_t max_parallel);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,358 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2025 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions
+// and limitations under the License.
+
+/**
+ *
+ * @file motioncyclic.c
+ *
+ * Deadlines are kept on the grid start + n * period, so a late cycle never
+ * shifts the phase of the following ones. The wait sleeps until spin_ns
+ * before the deadline and polls the clock for the rest.
+ *
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#include "motioncyclic.h"
+#include "motionentry.h"
+#include "debug.h"
+#include "common.h"
+
+#define MOTIONCYCLIC_LOG "MOTION_CYCLIC: "
+
+#define CYCLIC_NSEC_PER_SEC (1000000000LL)
+
+#ifndef SCHED_DEADLINE
+#define SCHED_DEADLINE (6)
+#endif
+
+/* Not exported by every libc */
+struct cyclic_sched_attr{
+    uint32_t size;
+    uint32_t sched_policy;
+    uint64_t sched_flags;
+    int32_t sched_nice;
+    uint32_t sched_priority;
+    uint64_t sched_runtime;
+    uint64_t sched_deadline;
+    uint64_t sched_period;
+};
+
+static int64_t cyclic_clock_now(void* ctx)
+{
+    struct timespec ts;
+
+    (void)ctx;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * CYCLIC_NSEC_PER_SEC + ts.tv_nsec;
+}
+
+static void cyclic_clock_sleep_until(void* ctx, int64_t time)
+{
+    struct timespec ts;
+
+    (void)ctx;
+    ts.tv_sec = time / CYCLIC_NSEC_PER_SEC;
+    ts.tv_nsec = time % CYCLIC_NSEC_PER_SEC;
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR);
+}
+
+static const motion_cyclic_clock_t cyclic_monotonic_clock = {
+    .now = cyclic_clock_now,
+    .sleep_until = cyclic_clock_sleep_until,
+    .ctx = NULL,
+};
+
+static inline void cyclic_relax(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+void motion_cyclic_config_init(motion_cyclic_config_t* config, uint32_t period_ns)
+{
+    memset(config, 0, sizeof(motion_cyclic_config_t));
+    config->period_ns = period_ns;
+    config->sched_policy = CYCLIC_SCHED_FIFO;
+    config->priority = CYCLIC_DEFAULT_PRIORITY;
+    config->cpu = -1;
+    config->overrun = CYCLIC_OVERRUN_SKIP;
+    config->max_catch_up = CYCLIC_DEFAULT_MAX_CATCH_UP;
+    config->degrade_after = CYCLIC_DEFAULT_DEGRADE_AFTER;
+    config->recover_after = CYCLIC_DEFAULT_RECOVER_AFTER;
+    config->max_divider = CYCLIC_DEFAULT_MAX_DIVIDER;
+}
+
+motion_cyclic_t* motion_cyclic_create(const motion_cyclic_config_t* config)
+{
+    motion_cyclic_t* runner;
+
+    if (!config || !config->period_ns) {
+        MOTION_CONSOLE_ERR(MOTIONCYCLIC_LOG "no period given\n");
+        return NULL;
+    }
+    if (config->spin_ns >= config->period_ns) {
+        MOTION_CONSOLE_ERR(MOTIONCYCLIC_LOG "spin time %u exceeds period %u\n", config->spin_ns, config->period_ns);
+        return NULL;
+    }
+    if (config->overrun > CYCLIC_OVERRUN_DEGRADE) {
+        MOTION_CONSOLE_ERR(MOTIONCYCLIC_LOG "unknown overrun policy %d\n", config->overrun);
+        return NULL;
+    }
+    runner = ecat_malloc(sizeof(motion_cyclic_t));
+    if (!runner) {
+        MOTION_CONSOLE_ERR(MOTIONCYCLIC_LOG "runner alloc fail\n");
+        return NULL;
+    }
+    memset(runner, 0, sizeof(motion_cyclic_t));
+    runner->config = *config;
+    if (!runner->config.max_divider) {
+        runner->config.max_divider = 1;
+    }
+    runner->clock = config->clock ? *config->clock : cyclic_monotonic_clock;
+    runner->divider = 1;
+    runner->stats.latency_min = INT64_MAX;
+    runner->stats.exec_min = INT64_MAX;
+    return runner;
+}
+
+void motion_cyclic_free(motion_cyclic_t* runner)
+{
+    if (!runner) {
+        return;
+    }
+    if (runner->started) {
+        motion_cyclic_stop(runner);
+    }
+    ecat_free(runner);
+}
+
+static void cyclic_wait(motion_cyclic_t* runner, int64_t deadline)
+{
+    motion_cyclic_clock_t* clock = &runner->clock;
+    uint32_t spin_ns = runner->config.spin_ns;
+
+    if (!spin_ns) {
+        clock->sleep_until(clock->ctx, deadline);
+        return;
+    }
+    if (clock->now(clock->ctx) < deadline - spin_ns) {
+        clock->sleep_until(clock->ctx, deadline - spin_ns);
+    }
+    while (clock->now(clock->ctx) < deadline) {
+        cyclic_relax();
+    }
+}
+
+/* Sets the next deadline from the end of the cycle just run */
+static void cyclic_plan(motion_cyclic_t* runner, int64_t end)
+{
+    motion_cyclic_config_t* config = &runner->config;
+    int64_t step = (int64_t)config->period_ns * runner->divider;
+    int64_t next = runner->next + step;
+    int64_t passed;
+
+    if (end <= next) {
+        runner->overrun_run = 0;
+        if (runner->divider == 1) {
+            runner->next = next;
+            return;
+        }
+        /* Only cycles that would fit the shorter period count for recovery */
+        if (end > runner->next + step / 2) {
+            runner->in_time_run = 0;
+        } else if (++runner->in_time_run >= config->recover_after) {
+            runner->divider >>= 1;
+            runner->in_time_run = 0;
+        }
+        runner->next = next;
+        return;
+    }
+
+    /* Deadlines of the current period already passed */
+    passed = (end - next) / step + 1;
+    runner->stats.overruns++;
+    runner->overrun_run++;
+    runner->in_time_run = 0;
+
+    if ((config->overrun == CYCLIC_OVERRUN_CATCH_UP) && (passed <= config->max_catch_up)) {
+        runner->next = next;
+        return;
+    }
+    if ((config->overrun == CYCLIC_OVERRUN_DEGRADE) && (runner->overrun_run >= config->degrade_after)
+        && (runner->divider * 2 <= config->max_divider)) {
+        runner->divider <<= 1;
+        runner->overrun_run = 0;
+    }
+    runner->next = next + passed * step;
+    runner->missed = (uint32_t)(passed * step / config->period_ns);
+    runner->stats.missed += runner->missed;
+}
+
+int motion_cyclic_run(motion_cyclic_t* runner, uint64_t cycles)
+{
+    motion_cyclic_config_t* config = &runner->config;
+    motion_cyclic_clock_t* clock = &runner->clock;
+    motion_cyclic_stats_t* stats = &runner->stats;
+    motion_cyclic_info_t info;
+    int64_t end, latency, exec;
+    uint64_t n;
+    int ret = ECAT_OKAY;
+
+    if (!runner->armed) {
+        runner->start = clock->now(clock->ctx) + config->period_ns;
+        runner->next = runner->start;
+        runner->armed = 1;
+    }
+    for (n = 0; (!cycles || (n < cycles)) && !runner->stop; n++) {
+        cyclic_wait(runner, runner->next);
+
+        info.wakeup = clock->now(clock->ctx);
+        info.deadline = runner->next;
+        info.cycle = (uint64_t)(runner->next - runner->start) / config->period_ns;
+        info.period_ns = config->period_ns * runner->divider;
+        info.missed = runner->missed;
+        runner->missed = 0;
+
+        if ((config->receive && config->receive(config->arg, &info))
+            || (config->process && config->process(config->arg, &info))
+            || (config->send && config->send(config->arg, &info))) {
+            ret = ECAT_FAIL;
+            runner->stop = 1;
+        }
+
+        end = clock->now(clock->ctx);
+        latency = info.wakeup - info.deadline;
+        exec = end - info.wakeup;
+        stats->cycles++;
+        stats->latency_sum += latency;
+        stats->exec_sum += exec;
+        if (latency < stats->latency_min) {
+            stats->latency_min = latency;
+        }
+        if (latency > stats->latency_max) {
+            stats->latency_max = latency;
+        }
+        if (exec < stats->exec_min) {
+            stats->exec_min = exec;
+        }
+        if (exec > stats->exec_max) {
+            stats->exec_max = exec;
+        }
+        cyclic_plan(runner, end);
+    }
+    return ret;
+}
+
+/* Applies affinity and policy of the config to the calling thread. A
+ * deadline task takes its CPUs from the exclusive cpuset it runs in, the
+ * kernel rejects SCHED_DEADLINE for a thread pinned by affinity. */
+int motion_cyclic_set_sched(const motion_cyclic_config_t* config)
+{
+    struct sched_param param;
+    struct cyclic_sched_attr attr;
+    cpu_set_t cpuset;
+    int err;
+
+    if (config->cpu >= 0 && config->sched_policy != CYCLIC_SCHED_DEADLINE) {
+        CPU_ZERO(&cpuset);
+        CPU_SET(config->cpu, &cpuset);
+        err = pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset);
+        if (err) {
+            MOTION_CONSOLE_ERR(MOTIONCYCLIC_LOG "fail to pin to cpu %d: %s\n", config->cpu, strerror(err));
+            return ECAT_FAIL;
+        }
+    }
+    switch (config->sched_policy) {
+    case CYCLIC_SCHED_FIFO:
+        param.sched_priority = config->priority;
+        err = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if (err) {
+            MOTION_CONSOLE_ERR(MOTIONCYCLIC_LOG "fail to set SCHED_FIFO: %s\n", strerror(err));
+            return ECAT_FAIL;
+        }
+        break;
+    case CYCLIC_SCHED_DEADLINE:
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.sched_policy = SCHED_DEADLINE;
+        attr.sched_runtime = config->runtime_ns ? config->runtime_ns : config->period_ns / 2;
+        attr.sched_deadline = config->period_ns;
+        attr.sched_period = config->period_ns;
+        if (syscall(SYS_sched_setattr, 0, &attr, 0)) {
+            MOTION_CONSOLE_ERR(MOTIONCYCLIC_LOG "fail to set SCHED_DEADLINE: %s\n", strerror(errno));
+            return ECAT_FAIL;
+        }
+        break;
+    default:
+        break;
+    }
+    return ECAT_OKAY;
+}
+
+static void* cyclic_thread(void* arg)
+{
+    motion_cyclic_t* runner = (motion_cyclic_t*)arg;
+
+    if (motion_cyclic_set_sched(&runner->config) != ECAT_OKAY) {
+        MOTION_CONSOLE_WARN(MOTIONCYCLIC_LOG "running without the requested scheduling\n");
+    }
+    motion_cyclic_run(runner, 0);
+    return NULL;
+}
+
+int motion_cyclic_start(motion_cyclic_t* runner)
+{
+    int err;
+
+    if (runner->started) {
+        MOTION_CONSOLE_ERR(MOTIONCYCLIC_LOG "already started\n");
+        return ECAT_FAIL;
+    }
+    runner->stop = 0;
+    err = pthread_create(&runner->thread, NULL, cyclic_thread, runner);
+    if (err) {
+        MOTION_CONSOLE_ERR(MOTIONCYCLIC_LOG "fail to create thread: %s\n", strerror(err));
+        return ECAT_FAIL;
+    }
+    runner->started = 1;
+    return ECAT_OKAY;
+}
+
+int motion_cyclic_stop(motion_cyclic_t* runner)
+{
+    if (!runner->started) {
+        return ECAT_FAIL;
+    }
+    runner->stop = 1;
+    pthread_join(runner->thread, NULL);
+    runner->started = 0;
+    return ECAT_OKAY;
+}
+
+void motion_cyclic_get_stats(const motion_cyclic_t* runner, motion_cyclic_stats_t* stats)
+{
+    *stats = runner->stats;
+}
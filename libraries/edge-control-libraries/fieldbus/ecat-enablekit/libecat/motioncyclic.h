@@ -0,0 +1,135 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2025 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions
+// and limitations under the License.
+
+/**
+ *
+ * @file motioncyclic.h
+ *
+ * Cyclic task runner. Owns the real-time thread, wakes it on a fixed grid
+ * of deadlines and calls the receive, process and send hooks of the
+ * application every cycle. A cycle that ends after the next deadline is an
+ * overrun, handled by the configured policy.
+ *
+ */
+
+#ifndef __MOTION_CYCLIC_H__
+#define __MOTION_CYCLIC_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <pthread.h>
+
+/* Scheduling policy of the cyclic thread */
+enum{
+    CYCLIC_SCHED_OTHER = 0,
+    CYCLIC_SCHED_FIFO,
+    CYCLIC_SCHED_DEADLINE
+};
+
+/* Overrun policy */
+enum{
+    CYCLIC_OVERRUN_SKIP = 0,  /**< Drop missed deadlines, keep the phase. */
+    CYCLIC_OVERRUN_CATCH_UP,  /**< Run missed cycles back to back. */
+    CYCLIC_OVERRUN_DEGRADE    /**< Double the period while overrunning. */
+};
+
+#define CYCLIC_DEFAULT_PRIORITY         (99)
+#define CYCLIC_DEFAULT_MAX_CATCH_UP     (4)
+#define CYCLIC_DEFAULT_DEGRADE_AFTER    (3)
+#define CYCLIC_DEFAULT_RECOVER_AFTER    (1000)
+#define CYCLIC_DEFAULT_MAX_DIVIDER      (8)
+
+typedef struct{
+    uint64_t cycle;         /**< Deadlines since start, on the base grid. */
+    int64_t deadline;       /**< Planned start [ns]. */
+    int64_t wakeup;         /**< Actual start [ns]. */
+    uint32_t period_ns;     /**< Current period, a multiple of the base one. */
+    uint32_t missed;        /**< Deadlines dropped before this cycle. */
+} motion_cyclic_info_t;
+
+/* A hook returning non-zero stops the runner */
+typedef int (*motion_cyclic_hook_t)(void* arg, const motion_cyclic_info_t* info);
+
+/* Time source, CLOCK_MONOTONIC unless replaced, e.g. by a simulated clock */
+typedef struct{
+    int64_t (*now)(void* ctx);
+    void (*sleep_until)(void* ctx, int64_t time);
+    void* ctx;
+} motion_cyclic_clock_t;
+
+typedef struct{
+    uint32_t period_ns;         /**< Base period. */
+    uint8_t sched_policy;       /**< CYCLIC_SCHED_* */
+    int priority;               /**< SCHED_FIFO priority. */
+    uint32_t runtime_ns;        /**< SCHED_DEADLINE budget, 0 for half the period. */
+    int cpu;                    /**< CPU of the thread, -1 for any. Not used with SCHED_DEADLINE. */
+    uint32_t spin_ns;           /**< Busy wait before the deadline, 0 for none. */
+    uint8_t overrun;            /**< CYCLIC_OVERRUN_* */
+    uint32_t max_catch_up;      /**< Missed cycles caught up, more are skipped. */
+    uint32_t degrade_after;     /**< Overruns in a row that double the period. */
+    uint32_t recover_after;     /**< Cycles in time that halve it again. */
+    uint32_t max_divider;       /**< Largest period as multiple of the base. */
+    motion_cyclic_hook_t receive;
+    motion_cyclic_hook_t process;
+    motion_cyclic_hook_t send;
+    void* arg;                  /**< Argument of the hooks. */
+    const motion_cyclic_clock_t* clock;  /**< NULL for CLOCK_MONOTONIC. */
+} motion_cyclic_config_t;
+
+typedef struct{
+    uint64_t cycles;        /**< Cycles run. */
+    uint64_t overruns;      /**< Cycles that ended after the next deadline. */
+    uint64_t missed;        /**< Deadlines dropped. */
+    int64_t latency_min;    /**< Wake-up after the deadline [ns]. */
+    int64_t latency_max;
+    int64_t latency_sum;
+    int64_t exec_min;       /**< Hook run time [ns]. */
+    int64_t exec_max;
+    int64_t exec_sum;
+} motion_cyclic_stats_t;
+
+typedef struct{
+    motion_cyclic_config_t config;
+    motion_cyclic_clock_t clock;
+    motion_cyclic_stats_t stats;
+    int64_t start;          /**< Deadline of cycle 0. */
+    int64_t next;           /**< Next deadline. */
+    uint32_t divider;       /**< Period as multiple of the base one. */
+    uint32_t overrun_run;   /**< Overruns in a row. */
+    uint32_t in_time_run;   /**< Cycles in time since the last overrun. */
+    uint32_t missed;        /**< Deadlines dropped before the next cycle. */
+    int armed;              /**< Grid set up by the first run. */
+    volatile int stop;
+    int started;            /**< Thread running. */
+    pthread_t thread;
+} motion_cyclic_t;
+
+void motion_cyclic_config_init(motion_cyclic_config_t* config, uint32_t period_ns);
+motion_cyclic_t* motion_cyclic_create(const motion_cyclic_config_t* config);
+void motion_cyclic_free(motion_cyclic_t* runner);
+int motion_cyclic_run(motion_cyclic_t* runner, uint64_t cycles);
+int motion_cyclic_start(motion_cyclic_t* runner);
+int motion_cyclic_stop(motion_cyclic_t* runner);
+int motion_cyclic_set_sched(const motion_cyclic_config_t* config);
+void motion_cyclic_get_stats(const motion_cyclic_t* runner, motion_cyclic_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
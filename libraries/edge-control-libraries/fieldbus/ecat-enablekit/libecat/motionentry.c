@@ -37,7 +37,6 @@
 #include <libxml/xmlmemory.h>
 
 #define MOTIONENTRY_LOG "MOTION_ENTRY: "
-#define SLAVE_PHYS_ADDR_OFFSET 1001
 
 static void motion_slave_free_pdo(servo_pdo_info_t* pdo_info);
 static void motion_slave_free_pdo_entry(servo_pdo_entry_info_t* entry_info);
@@ -1230,6 +1229,65 @@ int motion_servo_slave_config_idn(servo_master* servomaster, uint16_t alias, uin
     return ECAT_FAIL;
 }
 
+static int motion_servo_plan_sdo_download(void* ctx, uint16_t position, uint16_t index, uint8_t subindex,
+        const uint8_t* data, size_t size, uint32_t* abort_code)
+{
+    return ecrt_master_sdo_download((ec_master_t*)ctx, position, index, subindex, data, size, abort_code);
+}
+
+static int motion_servo_plan_sdo_upload(void* ctx, uint16_t position, uint16_t index, uint8_t subindex,
+        uint8_t* data, size_t size, size_t* result_size, uint32_t* abort_code)
+{
+    return ecrt_master_sdo_upload((ec_master_t*)ctx, position, index, subindex, data, size, result_size, abort_code);
+}
+
+static int motion_servo_plan_idn_write(void* ctx, uint16_t position, uint8_t drive_no, uint16_t idn,
+        const uint8_t* data, size_t size, uint16_t* error_code)
+{
+    return ecrt_master_write_idn((ec_master_t*)ctx, position, drive_no, idn, data, size, error_code);
+}
+
+int motion_servo_slave_config_parallel(servo_master* servomaster, motion_config_plan_t* plan, uint32_t max_parallel)
+{
+    motion_config_transport_t transport;
+    motion_config_plan_t* eni_plan = NULL;
+    int ret;
+    if ((!servomaster)||(!servomaster->master)) {
+        MOTION_CONSOLE_ERR("master have not requested\n");
+        return ECAT_FAIL;
+    }
+    if (!plan) {
+        if (!servomaster->eni_info) {
+            MOTION_CONSOLE_ERR(MOTIONENTRY_LOG "ENI information is NULL\n");
+            return ECAT_FAIL;
+        }
+        eni_plan = motion_config_plan_create();
+        if (!eni_plan) {
+            return ECAT_FAIL;
+        }
+        if (motion_config_plan_load_eni(eni_plan, &((ecat_eni*)servomaster->eni_info)->config,
+                ENI_TRANSITION_IP_TYPE|ENI_TRANSITION_PS_TYPE)) {
+            motion_config_plan_free(eni_plan);
+            return ECAT_FAIL;
+        }
+        plan = eni_plan;
+    }
+#ifdef EC_ENABLE_USERMODE
+    /* The user mode master passes every request through one IPC slot */
+    max_parallel = 1;
+#endif
+    memset(&transport, 0, sizeof(transport));
+    transport.sdo_download = motion_servo_plan_sdo_download;
+    transport.sdo_upload = motion_servo_plan_sdo_upload;
+    transport.idn_write = motion_servo_plan_idn_write;
+    transport.ctx = (void*)servomaster->master->master;
+    ret = motion_config_plan_execute(plan, &transport, max_parallel);
+    if (eni_plan) {
+        motion_config_plan_free(eni_plan);
+    }
+    return ret;
+}
+
 
 int motion_servo_recv_process(servo_master_t* master, void* domain)
 {
@@ -27,6 +27,7 @@ extern "C" {
 #endif
 
 #include <ecrt.h>
+#include "motionconfigplan.h"
 
 #ifndef NSEC_PER_SEC
 #define NSEC_PER_SEC        (1000000000L)
@@ -38,6 +39,8 @@ extern "C" {
 #define DIFF_NS(A,B)        (((B).tv_sec - (A).tv_sec)*NSEC_PER_SEC + ((B).tv_nsec)-(A).tv_nsec)
 #endif
 
+#define SLAVE_PHYS_ADDR_OFFSET 1001
+
 #define DOMAIN_INVAILD_OFFSET	(0xFFFFFFFF)
 #define DC_INVAILD_OFFSET	(0xFFFFFFFF)
 
@@ -174,6 +177,10 @@ int motion_servo_slave_config_sdo16(servo_master* servomaster, uint16_t alias, u
 int motion_servo_slave_config_sdo32(servo_master* servomaster, uint16_t alias, uint16_t position, uint16_t sdo_index, uint8_t sdo_subindex, uint32_t value);
 int motion_servo_slave_config_idn(servo_master* servomaster, uint16_t alias, uint16_t position, uint8_t drv_no, uint16_t idn, const uint8_t *data, size_t size);
 
+/* Mailbox configuration of several slaves at once, before activation. plan NULL for the IP and PS InitCmds of the ENI.
+ * The user mode master configures one slave at a time. */
+int motion_servo_slave_config_parallel(servo_master* servomaster, motion_config_plan_t* plan, uint32_t max_parallel);
+
 int motion_servo_recv_process(servo_master_t* master, void* domain);
 int motion_servo_send_process(servo_master_t* master, void* domain);
 uint32_t motion_servo_sync_monitor_process(servo_master_t* master);
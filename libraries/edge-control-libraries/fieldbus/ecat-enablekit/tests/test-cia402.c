@@ -0,0 +1,393 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2025 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions
+// and limitations under the License.
+
+/**
+ *
+ * @file test-cia402.c
+ *
+ * Runs the CiA402 engine against scripted drive models, no hardware needed.
+ * Each model follows the controlword one cycle late like a real drive and
+ * can fault, home, fail homing or keep a stale homing attained bit.
+ *
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+#include <../libecat/motioncia402.h>
+
+#define MAX_AXES        128
+#define AXIS_SIZE       8
+#define TEST_AXES       32
+
+#define SW_VOLTAGE      0x0010
+
+typedef struct{
+    uint8_t state;
+    uint8_t mode;
+    uint16_t last_cw;
+    uint32_t timer;
+    /* script */
+    uint32_t fault_at;          /* cycle of a fault, 0 for none */
+    uint8_t resets_needed;      /* reset edges until the fault clears, 0xFF never */
+    uint32_t home_cycles;       /* homing duration */
+    uint8_t home_fails;         /* homing ends with an error */
+    /* observed */
+    uint8_t homing;
+    uint8_t homed;
+    uint8_t home_error;
+    uint32_t homed_at;
+    uint32_t reset_edges;
+} drive_model_t;
+
+static uint8_t in_pd[MAX_AXES * AXIS_SIZE];
+static uint8_t out_pd[MAX_AXES * AXIS_SIZE];
+static drive_model_t drives[MAX_AXES];
+static uint32_t cycle;
+static int failures;
+
+#define CHECK(cond, ...) do { \
+    if (!(cond)) { \
+        printf("FAIL %s:%d: ", __func__, __LINE__); \
+        printf(__VA_ARGS__); \
+        printf("\n"); \
+        failures++; \
+    } \
+} while (0)
+
+static const uint16_t state_sw[CIA402_STATE_COUNT] = {
+    [CIA402_STATE_NOT_READY]            = 0x0000,
+    [CIA402_STATE_SWITCH_ON_DISABLED]   = 0x0040,
+    [CIA402_STATE_READY_TO_SWITCH_ON]   = 0x0021 | SW_VOLTAGE,
+    [CIA402_STATE_SWITCHED_ON]          = 0x0023 | SW_VOLTAGE,
+    [CIA402_STATE_OPERATION_ENABLED]    = 0x0027 | SW_VOLTAGE,
+    [CIA402_STATE_QUICK_STOP_ACTIVE]    = 0x0007 | SW_VOLTAGE,
+    [CIA402_STATE_FAULT_REACTION_ACTIVE] = 0x000F,
+    [CIA402_STATE_FAULT]                = 0x0008,
+};
+
+/* Applies the controlword written in the last cycle, as in CiA402 figure 9 */
+static void drive_update(drive_model_t* d, uint32_t axis)
+{
+    uint16_t cw = MOTION_DOMAIN_READ_U16(out_pd + axis * AXIS_SIZE);
+    int8_t mode = MOTION_DOMAIN_READ_S8(out_pd + axis * AXIS_SIZE + 2);
+    uint16_t sw;
+
+    if (d->fault_at && cycle == d->fault_at) {
+        d->state = CIA402_STATE_FAULT_REACTION_ACTIVE;
+        d->timer = 0;
+        d->homing = 0;
+    }
+
+    switch (d->state) {
+    case CIA402_STATE_NOT_READY:
+        if (++d->timer > 3) {
+            d->state = CIA402_STATE_SWITCH_ON_DISABLED;
+        }
+        break;
+    case CIA402_STATE_FAULT_REACTION_ACTIVE:
+        if (++d->timer > 2) {
+            d->state = CIA402_STATE_FAULT;
+        }
+        break;
+    case CIA402_STATE_FAULT:
+        if ((cw & 0x80) && !(d->last_cw & 0x80)) {
+            d->reset_edges++;
+            if ((d->resets_needed != 0xFF) && (d->reset_edges >= d->resets_needed)) {
+                d->state = CIA402_STATE_SWITCH_ON_DISABLED;
+            }
+        }
+        break;
+    case CIA402_STATE_SWITCH_ON_DISABLED:
+        if ((cw & 0x87) == 0x06) {
+            d->state = CIA402_STATE_READY_TO_SWITCH_ON;
+        }
+        break;
+    case CIA402_STATE_READY_TO_SWITCH_ON:
+        if ((cw & 0x82) == 0x00 || (cw & 0x86) == 0x02) {
+            d->state = CIA402_STATE_SWITCH_ON_DISABLED;
+        } else if ((cw & 0x8F) == 0x07 || (cw & 0x8F) == 0x0F) {
+            d->state = CIA402_STATE_SWITCHED_ON;
+        }
+        break;
+    case CIA402_STATE_SWITCHED_ON:
+        if ((cw & 0x82) == 0x00 || (cw & 0x86) == 0x02) {
+            d->state = CIA402_STATE_SWITCH_ON_DISABLED;
+        } else if ((cw & 0x87) == 0x06) {
+            d->state = CIA402_STATE_READY_TO_SWITCH_ON;
+        } else if ((cw & 0x8F) == 0x0F) {
+            d->state = CIA402_STATE_OPERATION_ENABLED;
+        }
+        break;
+    case CIA402_STATE_OPERATION_ENABLED:
+        if ((cw & 0x82) == 0x00) {
+            d->state = CIA402_STATE_SWITCH_ON_DISABLED;
+        } else if ((cw & 0x86) == 0x02) {
+            d->state = CIA402_STATE_QUICK_STOP_ACTIVE;
+        } else if ((cw & 0x87) == 0x06) {
+            d->state = CIA402_STATE_READY_TO_SWITCH_ON;
+        } else if ((cw & 0x8F) == 0x07) {
+            d->state = CIA402_STATE_SWITCHED_ON;
+        }
+        break;
+    case CIA402_STATE_QUICK_STOP_ACTIVE:
+        if ((cw & 0x82) == 0x00) {
+            d->state = CIA402_STATE_SWITCH_ON_DISABLED;
+        }
+        break;
+    }
+
+    /* homing starts on a rising edge of bit 4 in MODE_HM */
+    if ((d->state == CIA402_STATE_OPERATION_ENABLED) && (d->mode == MODE_HM)) {
+        if ((cw & 0x10) && !(d->last_cw & 0x10)) {
+            d->homing = 1;
+            d->homed = 0;
+            d->home_error = 0;
+            d->timer = 0;
+        } else if (d->homing && !(cw & 0x10)) {
+            d->homing = 0; /* halted */
+        } else if (d->homing && (++d->timer >= d->home_cycles)) {
+            d->homing = 0;
+            if (d->home_fails) {
+                d->home_error = 1;
+            } else {
+                d->homed = 1;
+                d->homed_at = cycle;
+            }
+        }
+    } else {
+        d->homing = 0;
+    }
+
+    d->mode = mode;
+    d->last_cw = cw;
+    sw = state_sw[d->state];
+    if (d->homed) {
+        sw |= CIA402_SW_HOMING_ATTAINED | CIA402_SW_TARGET_REACHED;
+    }
+    if (d->home_error) {
+        sw |= CIA402_SW_HOMING_ERROR;
+    }
+    MOTION_DOMAIN_WRITE_U16(in_pd + axis * AXIS_SIZE, sw);
+    MOTION_DOMAIN_WRITE_S8(in_pd + axis * AXIS_SIZE + 2, d->mode);
+}
+
+static motion_cia402_t* setup(uint32_t n_axes)
+{
+    motion_cia402_t* engine = motion_cia402_create(n_axes);
+    uint32_t i;
+
+    memset(in_pd, 0, sizeof(in_pd));
+    memset(out_pd, 0, sizeof(out_pd));
+    memset(drives, 0, sizeof(drives));
+    cycle = 0;
+    for (i = 0; i < n_axes; i++) {
+        drives[i].home_cycles = 20;
+        motion_cia402_set_axis(engine, i, i * AXIS_SIZE, i * AXIS_SIZE,
+            i * AXIS_SIZE + 2, i * AXIS_SIZE + 2, MODE_CSP);
+    }
+    return engine;
+}
+
+/* One bus cycle: the drives see the last outputs, the engine the new inputs */
+static void run(motion_cia402_t* engine, uint32_t cycles)
+{
+    uint32_t c, i;
+
+    for (c = 0; c < cycles; c++) {
+        cycle++;
+        for (i = 0; i < engine->n_axes; i++) {
+            drive_update(&drives[i], i);
+        }
+        motion_cia402_step(engine, in_pd, out_pd);
+    }
+}
+
+static void test_enable(void)
+{
+    motion_cia402_t* engine = setup(TEST_AXES);
+    uint32_t i;
+
+    motion_cia402_request_all(engine, CIA402_REQ_ENABLE);
+    run(engine, 20);
+    CHECK(engine->n_enabled == TEST_AXES, "%u of %u axes enabled", engine->n_enabled, TEST_AXES);
+    for (i = 0; i < TEST_AXES; i++) {
+        CHECK(drives[i].state == CIA402_STATE_OPERATION_ENABLED, "axis %u in state %u", i, drives[i].state);
+        CHECK(motion_cia402_axis_ready(engine, i), "axis %u not ready", i);
+        CHECK(drives[i].mode == MODE_CSP, "axis %u in mode %d", i, drives[i].mode);
+    }
+
+    motion_cia402_request(engine, 3, CIA402_REQ_QUICK_STOP);
+    motion_cia402_request(engine, 4, CIA402_REQ_DISABLE);
+    run(engine, 10);
+    CHECK(drives[3].state == CIA402_STATE_QUICK_STOP_ACTIVE, "quick stop axis in state %u", drives[3].state);
+    CHECK(drives[4].state == CIA402_STATE_SWITCH_ON_DISABLED, "disabled axis in state %u", drives[4].state);
+    CHECK(engine->n_enabled == TEST_AXES - 2, "%u axes enabled", engine->n_enabled);
+
+    motion_cia402_request(engine, 3, CIA402_REQ_ENABLE);
+    motion_cia402_request(engine, 4, CIA402_REQ_ENABLE);
+    run(engine, 20);
+    CHECK(engine->n_enabled == TEST_AXES, "%u axes enabled again", engine->n_enabled);
+    motion_cia402_free(engine);
+}
+
+static void test_fault_reset(void)
+{
+    motion_cia402_t* engine = setup(TEST_AXES);
+    uint32_t i, interrupted = 0;
+
+    drives[5].fault_at = 30;
+    drives[5].resets_needed = 2;
+    drives[7].fault_at = 40;
+    drives[7].resets_needed = 0xFF;
+    motion_cia402_request_all(engine, CIA402_REQ_ENABLE);
+    run(engine, 20);
+    for (i = 0; i < 200; i++) {
+        run(engine, 1);
+        if (engine->n_enabled + (drives[5].state != CIA402_STATE_OPERATION_ENABLED) +
+            (drives[7].state != CIA402_STATE_OPERATION_ENABLED) < TEST_AXES) {
+            interrupted++;
+        }
+    }
+    CHECK(!interrupted, "healthy axes left operation for %u cycles", interrupted);
+    CHECK(drives[5].state == CIA402_STATE_OPERATION_ENABLED, "axis 5 in state %u", drives[5].state);
+    CHECK(drives[5].reset_edges == 2, "axis 5 saw %u reset edges", drives[5].reset_edges);
+    CHECK(!(engine->axes[5].flags & CIA402_FLAG_FAULT), "axis 5 flagged");
+    CHECK(drives[7].state == CIA402_STATE_FAULT, "axis 7 in state %u", drives[7].state);
+    CHECK(drives[7].reset_edges == CIA402_DEFAULT_FAULT_RESET_RETRIES, "axis 7 saw %u reset edges",
+        drives[7].reset_edges);
+    CHECK(engine->axes[7].flags & CIA402_FLAG_FAULT, "axis 7 not flagged");
+    CHECK(engine->n_faulted == 1, "%u axes faulted", engine->n_faulted);
+
+    /* a new request retries the reset */
+    drives[7].resets_needed = drives[7].reset_edges + 1;
+    motion_cia402_request(engine, 7, CIA402_REQ_ENABLE);
+    run(engine, 40);
+    CHECK(drives[7].state == CIA402_STATE_OPERATION_ENABLED, "axis 7 in state %u", drives[7].state);
+    CHECK(engine->n_enabled == TEST_AXES, "%u axes enabled", engine->n_enabled);
+    motion_cia402_free(engine);
+}
+
+static void test_homing(void)
+{
+    motion_cia402_t* engine = setup(TEST_AXES);
+    uint32_t i, early = 0;
+
+    for (i = 0; i < TEST_AXES; i++) {
+        drives[i].home_cycles = 20 + i * 3;
+        /* axes 0-3 report attained from an earlier homing */
+        drives[i].homed = i < 4;
+    }
+    drives[9].home_fails = 1;
+    motion_cia402_request_all(engine, CIA402_REQ_HOME);
+    for (i = 0; i < 300; i++) {
+        run(engine, 1);
+        for (uint32_t a = 0; a < TEST_AXES; a++) {
+            if ((engine->axes[a].flags & CIA402_FLAG_HOMED) && !drives[a].homed_at) {
+                early++;
+            }
+        }
+    }
+    CHECK(!early, "homed flagged %u times before the drive homed", early);
+    for (i = 0; i < TEST_AXES; i++) {
+        if (i == 9) {
+            continue;
+        }
+        CHECK(engine->axes[i].flags & CIA402_FLAG_HOMED, "axis %u not homed", i);
+        CHECK(engine->axes[i].request == CIA402_REQ_ENABLE, "axis %u request %u", i, engine->axes[i].request);
+        CHECK(drives[i].mode == MODE_CSP, "axis %u in mode %d", i, drives[i].mode);
+        CHECK(motion_cia402_axis_ready(engine, i), "axis %u not ready", i);
+    }
+    CHECK(engine->axes[9].flags & CIA402_FLAG_HOME_ERROR, "axis 9 homing error not flagged");
+    CHECK(drives[9].state == CIA402_STATE_SWITCH_ON_DISABLED, "axis 9 in state %u", drives[9].state);
+    CHECK(engine->n_enabled == TEST_AXES - 1, "%u axes enabled", engine->n_enabled);
+
+    /* timeout */
+    drives[9].home_fails = 0;
+    drives[9].home_cycles = 1000;
+    engine->home_timeout_cycles = 100;
+    motion_cia402_request(engine, 9, CIA402_REQ_HOME);
+    run(engine, 200);
+    CHECK(engine->axes[9].flags & CIA402_FLAG_HOME_ERROR, "axis 9 timeout not flagged");
+    CHECK(!(engine->axes[9].flags & CIA402_FLAG_HOMED), "axis 9 homed");
+    motion_cia402_free(engine);
+}
+
+static int64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+/* Step cost with every axis enabled, printed per axis count */
+static void test_step_cost(void)
+{
+    static const uint32_t counts[] = {1, 8, 32, 64, 128};
+    uint32_t i, c, cycles = 10000;
+    int64_t t, sum;
+
+    printf("axes  ns/step  ns/axis\n");
+    for (i = 0; i < sizeof(counts) / sizeof(counts[0]); i++) {
+        motion_cia402_t* engine = setup(counts[i]);
+        motion_cia402_request_all(engine, CIA402_REQ_ENABLE);
+        run(engine, 20);
+        CHECK(engine->n_enabled == counts[i], "%u of %u axes enabled", engine->n_enabled, counts[i]);
+        sum = 0;
+        for (c = 0; c < cycles; c++) {
+            t = now_ns();
+            motion_cia402_step(engine, in_pd, out_pd);
+            sum += now_ns() - t;
+        }
+        printf("%4u %8lld %8lld\n", counts[i], (long long)(sum / cycles),
+            (long long)(sum / cycles / counts[i]));
+        motion_cia402_free(engine);
+    }
+}
+
+/* The state table of the step must agree with motion_cia402_decode() */
+static void test_decode(void)
+{
+    motion_cia402_t* engine = setup(1);
+    uint32_t sw, wrong = 0;
+
+    for (sw = 0; sw < 0x10000; sw++) {
+        MOTION_DOMAIN_WRITE_U16(in_pd, sw);
+        motion_cia402_step(engine, in_pd, out_pd);
+        if (engine->axes[0].state != motion_cia402_decode(sw)) {
+            wrong++;
+        }
+    }
+    CHECK(!wrong, "%u statuswords decoded differently", wrong);
+    for (sw = 0; sw < CIA402_STATE_COUNT; sw++) {
+        CHECK(motion_cia402_decode(state_sw[sw]) == sw, "state %u decoded as %u", sw,
+            motion_cia402_decode(state_sw[sw]));
+    }
+    motion_cia402_free(engine);
+}
+
+int main(int argc, char **argv)
+{
+    test_decode();
+    test_enable();
+    test_fault_reset();
+    test_homing();
+    test_step_cost();
+
+    printf("%s\n", failures ? "FAILED" : "PASSED");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,522 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2025 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions
+// and limitations under the License.
+
+/**
+ *
+ * @file test-configplan.c
+ *
+ * Runs configuration plans against a scripted mailbox responder. Every
+ * slave of the responder expects a fixed sequence of requests and answers
+ * each after a delay, with the scripted abort code. The responder checks
+ * the order of the requests and that a slave never has two at once.
+ *
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <libxml/parser.h>
+#include <libxml/tree.h>
+#include <libxml/xpath.h>
+#include <../libecat/motionconfigplan.h>
+#include <../libecat/motionentry.h>
+#include <../eniconfig/eniconfig.h>
+
+/* Source directory of the tests, the build passes it so that the fixtures are
+ * found from any directory */
+#ifndef TEST_SRCDIR
+#define TEST_SRCDIR "tests"
+#endif
+
+#define MAX_SLAVES      (64)
+#define MAX_SCRIPT      (128)
+#define MAX_DATA        (16)
+#define LATENCY_US      (1000)
+
+typedef struct{
+    uint8_t type;
+    uint16_t index;
+    uint8_t subindex;
+    uint8_t data[MAX_DATA];     /* expected download, or upload reply */
+    uint32_t size;
+    uint32_t abort_code;        /* reply, 0 for success */
+} script_step_t;
+
+typedef struct{
+    script_step_t steps[MAX_SCRIPT];
+    uint32_t n_steps;
+    uint32_t next;
+    int busy;
+    uint32_t overlaps;          /* requests while one was in flight */
+    uint32_t unexpected;        /* requests not matching the script */
+    int64_t first_ns;
+    int64_t last_ns;
+} script_slave_t;
+
+typedef struct{
+    pthread_mutex_t lock;
+    script_slave_t slaves[MAX_SLAVES];
+    uint32_t latency_us;
+    uint32_t in_flight;
+    uint32_t max_in_flight;
+} responder_t;
+
+static int failures;
+
+#define CHECK(cond, ...) do { \
+    if (!(cond)) { \
+        printf("FAIL %s:%d: ", __func__, __LINE__); \
+        printf(__VA_ARGS__); \
+        printf("\n"); \
+        failures++; \
+    } \
+} while (0)
+
+static int64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)TIMESPEC2NS(ts);
+}
+
+static void responder_init(responder_t* resp, uint32_t latency_us)
+{
+    memset(resp, 0, sizeof(*resp));
+    pthread_mutex_init(&resp->lock, NULL);
+    resp->latency_us = latency_us;
+}
+
+static script_step_t* script_add(responder_t* resp, uint16_t position, uint8_t type, uint16_t index, uint8_t subindex,
+        const void* data, uint32_t size, uint32_t abort_code)
+{
+    script_slave_t* slave = &resp->slaves[position];
+    script_step_t* step = &slave->steps[slave->n_steps++];
+    step->type = type;
+    step->index = index;
+    step->subindex = subindex;
+    step->size = size;
+    if (size) {
+        memcpy(step->data, data, size);
+    }
+    step->abort_code = abort_code;
+    return step;
+}
+
+/* One mailbox round trip, returns the abort code */
+static uint32_t responder_request(responder_t* resp, uint8_t type, uint16_t position, uint16_t index, uint8_t subindex,
+        const uint8_t* data, size_t size, uint8_t* reply, size_t reply_size, size_t* result_size)
+{
+    script_slave_t* slave;
+    script_step_t* step = NULL;
+    uint32_t abort_code = 0x08000000;
+
+    if (position >= MAX_SLAVES) {
+        return abort_code;
+    }
+    slave = &resp->slaves[position];
+    pthread_mutex_lock(&resp->lock);
+    if (slave->busy) {
+        slave->overlaps++;
+    }
+    slave->busy++;
+    if (!slave->first_ns) {
+        slave->first_ns = now_ns();
+    }
+    resp->in_flight++;
+    if (resp->in_flight > resp->max_in_flight) {
+        resp->max_in_flight = resp->in_flight;
+    }
+    if (slave->next < slave->n_steps) {
+        step = &slave->steps[slave->next++];
+        if ((step->type != type)||(step->index != index)||(step->subindex != subindex)
+                ||((type != CONFIG_STEP_SDO_UPLOAD)&&((step->size != size)||(memcmp(step->data, data, size))))) {
+            slave->unexpected++;
+            step = NULL;
+        }
+    } else {
+        slave->unexpected++;
+    }
+    pthread_mutex_unlock(&resp->lock);
+
+    usleep(resp->latency_us);
+
+    if (step) {
+        abort_code = step->abort_code;
+        if ((type == CONFIG_STEP_SDO_UPLOAD)&&(!abort_code)) {
+            memcpy(reply, step->data, step->size < reply_size ? step->size : reply_size);
+            *result_size = step->size;
+        }
+    }
+    pthread_mutex_lock(&resp->lock);
+    slave->busy--;
+    resp->in_flight--;
+    slave->last_ns = now_ns();
+    pthread_mutex_unlock(&resp->lock);
+    return abort_code;
+}
+
+static int responder_sdo_download(void* ctx, uint16_t position, uint16_t index, uint8_t subindex,
+        const uint8_t* data, size_t size, uint32_t* abort_code)
+{
+    *abort_code = responder_request((responder_t*)ctx, CONFIG_STEP_SDO_DOWNLOAD, position, index, subindex,
+        data, size, NULL, 0, NULL);
+    return *abort_code ? -1 : 0;
+}
+
+static int responder_sdo_upload(void* ctx, uint16_t position, uint16_t index, uint8_t subindex,
+        uint8_t* data, size_t size, size_t* result_size, uint32_t* abort_code)
+{
+    *abort_code = responder_request((responder_t*)ctx, CONFIG_STEP_SDO_UPLOAD, position, index, subindex,
+        NULL, 0, data, size, result_size);
+    return *abort_code ? -1 : 0;
+}
+
+static int responder_idn_write(void* ctx, uint16_t position, uint8_t drive_no, uint16_t idn,
+        const uint8_t* data, size_t size, uint16_t* error_code)
+{
+    *error_code = (uint16_t)responder_request((responder_t*)ctx, CONFIG_STEP_IDN_WRITE, position, idn, drive_no,
+        data, size, NULL, 0, NULL);
+    return *error_code ? -1 : 0;
+}
+
+static void responder_transport(responder_t* resp, motion_config_transport_t* transport)
+{
+    memset(transport, 0, sizeof(*transport));
+    transport->sdo_download = responder_sdo_download;
+    transport->sdo_upload = responder_sdo_upload;
+    transport->idn_write = responder_idn_write;
+    transport->ctx = resp;
+}
+
+static void check_responder(responder_t* resp, uint32_t n_slaves)
+{
+    uint32_t i;
+    for (i = 0; i < n_slaves; i++) {
+        script_slave_t* slave = &resp->slaves[i];
+        CHECK(!slave->overlaps, "slave %u had %u requests at once", i, slave->overlaps);
+        CHECK(!slave->unexpected, "slave %u got %u unexpected requests", i, slave->unexpected);
+    }
+}
+
+/* Scripts the CoE InitCmds of the ENI from the XML, independently of the parser */
+static uint32_t script_eni(responder_t* resp, const char* path)
+{
+    xmlDocPtr doc = xmlReadFile(path, NULL, XML_PARSE_NOBLANKS);
+    xmlXPathContextPtr ctx;
+    xmlXPathObjectPtr cmds;
+    uint32_t n = 0;
+    int i;
+
+    if (!doc) {
+        return 0;
+    }
+    ctx = xmlXPathNewContext(doc);
+    cmds = xmlXPathEvalExpression(BAD_CAST"//Slave/Mailbox/CoE/InitCmds/InitCmd", ctx);
+    for (i = 0; (cmds)&&(cmds->nodesetval)&&(i < cmds->nodesetval->nodeNr); i++) {
+        xmlNodePtr cmd = cmds->nodesetval->nodeTab[i];
+        xmlNodePtr slave = cmd->parent->parent->parent->parent;
+        xmlNodePtr node;
+        int position = -1, enabled = 1, in_plan = 0, index = 0, subindex = 0, ccs = 0;
+        uint8_t data[MAX_DATA];
+        uint32_t size = 0;
+
+        for (node = slave->children; node; node = node->next) {
+            if (!xmlStrcmp(node->name, BAD_CAST"Info")) {
+                xmlNodePtr info;
+                for (info = node->children; info; info = info->next) {
+                    if (!xmlStrcmp(info->name, BAD_CAST"PhysAddr")) {
+                        xmlChar* key = xmlNodeGetContent(info);
+                        position = atoi((const char*)key) - SLAVE_PHYS_ADDR_OFFSET;
+                        xmlFree(key);
+                    }
+                }
+            }
+        }
+        for (node = cmd->children; node; node = node->next) {
+            xmlChar* key = xmlNodeGetContent(node);
+            if (!xmlStrcmp(node->name, BAD_CAST"Transition")) {
+                in_plan |= !xmlStrcmp(key, BAD_CAST"IP") || !xmlStrcmp(key, BAD_CAST"PS");
+            } else if (!xmlStrcmp(node->name, BAD_CAST"Disabled")) {
+                enabled = !atoi((const char*)key);
+            } else if (!xmlStrcmp(node->name, BAD_CAST"Ccs")) {
+                ccs = atoi((const char*)key);
+            } else if (!xmlStrcmp(node->name, BAD_CAST"Index")) {
+                index = atoi((const char*)key);
+            } else if (!xmlStrcmp(node->name, BAD_CAST"SubIndex")) {
+                subindex = atoi((const char*)key);
+            } else if (!xmlStrcmp(node->name, BAD_CAST"Data")) {
+                const char* hex = (const char*)key;
+                unsigned int byte;
+                for (size = 0; (hex[2*size])&&(size < MAX_DATA)&&(sscanf(hex + 2*size, "%2x", &byte) == 1); size++) {
+                    data[size] = (uint8_t)byte;
+                }
+            }
+            xmlFree(key);
+        }
+        if ((position >= 0)&&(position < MAX_SLAVES)&&(enabled)&&(in_plan)) {
+            script_add(resp, position, ccs == 2 ? CONFIG_STEP_SDO_UPLOAD : CONFIG_STEP_SDO_DOWNLOAD,
+                index, subindex, data, size, 0);
+            n++;
+        }
+    }
+    xmlXPathFreeObject(cmds);
+    xmlXPathFreeContext(ctx);
+    xmlFreeDoc(doc);
+    return n;
+}
+
+static void test_eni(const char* path)
+{
+    responder_t resp;
+    motion_config_transport_t transport;
+    motion_config_plan_t* plan;
+    ecat_eni* eni;
+    uint32_t n_script, n_steps = 0, i;
+    int ret;
+
+    responder_init(&resp, 0);
+    responder_transport(&resp, &transport);
+    n_script = script_eni(&resp, path);
+    CHECK(n_script > 0, "no CoE InitCmds in %s", path);
+
+    eni = ecat_load_eni((char*)path);
+    CHECK(eni, "cannot load %s", path);
+    if (!eni) {
+        return;
+    }
+    plan = motion_config_plan_create();
+    ret = motion_config_plan_load_eni(plan, &eni->config, ENI_TRANSITION_IP_TYPE|ENI_TRANSITION_PS_TYPE);
+    CHECK(ret == ECAT_OKAY, "load_eni returned %d", ret);
+    for (i = 0; i < plan->n_slaves; i++) {
+        n_steps += plan->slaves[i].n_steps;
+    }
+    CHECK(n_steps == n_script, "%u steps planned, %u InitCmds in the ENI", n_steps, n_script);
+
+    ret = motion_config_plan_execute(plan, &transport, 0);
+    CHECK(ret == ECAT_OKAY, "execute returned %d", ret);
+    check_responder(&resp, MAX_SLAVES);
+    for (i = 0; i < plan->n_slaves; i++) {
+        motion_config_slave_t* slave = &plan->slaves[i];
+        CHECK(slave->state == CONFIG_SLAVE_DONE, "slave %u in state %u", slave->position, slave->state);
+        CHECK(resp.slaves[slave->position].next == resp.slaves[slave->position].n_steps,
+            "slave %u: %u of %u InitCmds sent", slave->position,
+            resp.slaves[slave->position].next, resp.slaves[slave->position].n_steps);
+    }
+    motion_config_plan_free(plan);
+    eni_config_free(eni);
+}
+
+static motion_config_plan_t* build_bus(responder_t* resp, uint32_t n_slaves, uint32_t n_steps)
+{
+    motion_config_plan_t* plan = motion_config_plan_create();
+    uint32_t i, j;
+    for (i = 0; i < n_slaves; i++) {
+        motion_config_plan_add_slave(plan, i, 0x66F, 0x613C0005);
+        for (j = 0; j < n_steps; j++) {
+            uint32_t value = (i << 16) | j;
+            motion_config_plan_add_sdo(plan, i, 0x2000 + j, 1, &value, sizeof(value));
+            script_add(resp, i, CONFIG_STEP_SDO_DOWNLOAD, 0x2000 + j, 1, &value, sizeof(value), 0);
+        }
+    }
+    return plan;
+}
+
+static void test_parallel(void)
+{
+    responder_t resp;
+    motion_config_transport_t transport;
+    motion_config_plan_t* plan;
+    int64_t parallel_ns, serial_ns;
+    uint32_t i;
+    int ret;
+
+    responder_init(&resp, LATENCY_US);
+    responder_transport(&resp, &transport);
+    plan = build_bus(&resp, MAX_SLAVES, 4);
+    ret = motion_config_plan_execute(plan, &transport, 16);
+    parallel_ns = plan->elapsed_ns;
+    CHECK(ret == ECAT_OKAY, "execute returned %d", ret);
+    CHECK(plan->n_done == MAX_SLAVES, "%u slaves done", plan->n_done);
+    check_responder(&resp, MAX_SLAVES);
+    for (i = 0; i < MAX_SLAVES; i++) {
+        CHECK(resp.slaves[i].next == 4, "slave %u: %u requests", i, resp.slaves[i].next);
+    }
+    CHECK((resp.max_in_flight > 1)&&(resp.max_in_flight <= 16), "%u transfers in flight", resp.max_in_flight);
+    CHECK(plan->max_in_flight <= 16, "%u slaves at once", plan->max_in_flight);
+
+    /* Same bus, one slave at a time */
+    for (i = 0; i < MAX_SLAVES; i++) {
+        resp.slaves[i].next = 0;
+    }
+    resp.max_in_flight = 0;
+    ret = motion_config_plan_execute(plan, &transport, 1);
+    serial_ns = plan->elapsed_ns;
+    CHECK(ret == ECAT_OKAY, "serial execute returned %d", ret);
+    CHECK(resp.max_in_flight == 1, "%u transfers in flight", resp.max_in_flight);
+    check_responder(&resp, MAX_SLAVES);
+    CHECK(parallel_ns * 4 < serial_ns, "parallel %lld ns, serial %lld ns",
+        (long long)parallel_ns, (long long)serial_ns);
+    printf("%u slaves x 4 SDOs, %u us round trip: serial %.1f ms, 16 parallel %.1f ms\n",
+        MAX_SLAVES, LATENCY_US, serial_ns / 1e6, parallel_ns / 1e6);
+    motion_config_plan_free(plan);
+}
+
+static void test_failure(void)
+{
+    responder_t resp;
+    motion_config_transport_t transport;
+    motion_config_plan_t* plan;
+    motion_config_slave_t* slave;
+    uint32_t i;
+    int ret;
+
+    responder_init(&resp, 100);
+    responder_transport(&resp, &transport);
+    plan = build_bus(&resp, 8, 4);
+    resp.slaves[3].steps[1].abort_code = 0x06090011;
+    motion_config_plan_add_dependency(plan, 5, 3);
+    motion_config_plan_add_dependency(plan, 6, 5);
+    ret = motion_config_plan_execute(plan, &transport, 4);
+    CHECK(ret == ECAT_FAIL, "execute returned %d", ret);
+    CHECK((plan->n_done == 5)&&(plan->n_failed == 1)&&(plan->n_blocked == 2),
+        "done %u failed %u blocked %u", plan->n_done, plan->n_failed, plan->n_blocked);
+
+    slave = motion_config_plan_get_slave(plan, 3);
+    CHECK(slave->state == CONFIG_SLAVE_FAILED, "slave 3 in state %u", slave->state);
+    CHECK(slave->error == CONFIG_ERROR_TRANSFER, "slave 3 error %u", slave->error);
+    CHECK(slave->failed_step == 1, "slave 3 failed at step %u", slave->failed_step);
+    CHECK(slave->abort_code == 0x06090011, "slave 3 abort code 0x%08x", slave->abort_code);
+    CHECK(resp.slaves[3].next == 2, "slave 3 got %u requests", resp.slaves[3].next);
+    for (i = 5; i <= 6; i++) {
+        slave = motion_config_plan_get_slave(plan, i);
+        CHECK((slave->state == CONFIG_SLAVE_BLOCKED)&&(slave->error == CONFIG_ERROR_DEPENDENCY),
+            "slave %u in state %u error %u", i, slave->state, slave->error);
+        CHECK(resp.slaves[i].next == 0, "slave %u got %u requests", i, resp.slaves[i].next);
+    }
+    for (i = 0; i < 8; i++) {
+        if ((i != 3)&&(i != 5)&&(i != 6)) {
+            slave = motion_config_plan_get_slave(plan, i);
+            CHECK(slave->state == CONFIG_SLAVE_DONE, "slave %u in state %u", i, slave->state);
+        }
+    }
+    check_responder(&resp, 8);
+    motion_config_plan_free(plan);
+}
+
+static void test_dependency(void)
+{
+    responder_t resp;
+    motion_config_transport_t transport;
+    motion_config_plan_t* plan;
+    script_slave_t* s;
+    int ret;
+
+    responder_init(&resp, 500);
+    responder_transport(&resp, &transport);
+    plan = build_bus(&resp, 4, 4);
+    motion_config_plan_add_dependency(plan, 2, 0);
+    motion_config_plan_add_dependency(plan, 3, 2);
+    ret = motion_config_plan_execute(plan, &transport, 4);
+    CHECK(ret == ECAT_OKAY, "execute returned %d", ret);
+    check_responder(&resp, 4);
+    s = resp.slaves;
+    CHECK(s[2].first_ns >= s[0].last_ns, "slave 2 started before slave 0 finished");
+    CHECK(s[3].first_ns >= s[2].last_ns, "slave 3 started before slave 2 finished");
+    CHECK(s[1].first_ns < s[0].last_ns, "slave 1 waited for slave 0");
+
+    /* Circular: 1 after 2 after 1, slave 0 is independent */
+    responder_init(&resp, 0);
+    motion_config_plan_free(plan);
+    plan = build_bus(&resp, 3, 2);
+    motion_config_plan_add_dependency(plan, 1, 2);
+    motion_config_plan_add_dependency(plan, 2, 1);
+    ret = motion_config_plan_execute(plan, &transport, 2);
+    CHECK(ret == ECAT_FAIL, "execute returned %d", ret);
+    CHECK(plan->slaves[0].state == CONFIG_SLAVE_DONE, "slave 0 in state %u", plan->slaves[0].state);
+    CHECK((plan->slaves[1].state == CONFIG_SLAVE_BLOCKED)&&(plan->slaves[2].state == CONFIG_SLAVE_BLOCKED),
+        "slaves 1 and 2 in state %u %u", plan->slaves[1].state, plan->slaves[2].state);
+    CHECK((resp.slaves[1].next == 0)&&(resp.slaves[2].next == 0), "blocked slaves got requests");
+    motion_config_plan_free(plan);
+}
+
+static void test_steps(void)
+{
+    responder_t resp;
+    motion_config_transport_t transport;
+    motion_config_plan_t* plan;
+    motion_config_step_t step;
+    const uint8_t expected[2] = {0x08, 0x00};
+    const uint8_t reply[2] = {0x09, 0x00};
+    const uint8_t idn_data[4] = {0xE8, 0x03, 0x00, 0x00};
+    motion_config_slave_t* slave;
+    int ret;
+
+    responder_init(&resp, 0);
+    responder_transport(&resp, &transport);
+    plan = motion_config_plan_create();
+
+    /* Slave 0: matching upload then an IDN, slave 1: upload differs */
+    memset(&step, 0, sizeof(step));
+    step.type = CONFIG_STEP_SDO_UPLOAD;
+    step.index = 0x6060;
+    step.data = (uint8_t*)expected;
+    step.size = 2;
+    motion_config_plan_add_step(plan, 0, &step);
+    motion_config_plan_add_step(plan, 1, &step);
+    script_add(&resp, 0, CONFIG_STEP_SDO_UPLOAD, 0x6060, 0, expected, 2, 0);
+    script_add(&resp, 1, CONFIG_STEP_SDO_UPLOAD, 0x6060, 0, reply, 2, 0);
+    memset(&step, 0, sizeof(step));
+    step.type = CONFIG_STEP_IDN_WRITE;
+    step.index = 32;
+    step.subindex = 1;
+    step.data = (uint8_t*)idn_data;
+    step.size = 4;
+    motion_config_plan_add_step(plan, 0, &step);
+    script_add(&resp, 0, CONFIG_STEP_IDN_WRITE, 32, 1, idn_data, 4, 0);
+
+    ret = motion_config_plan_execute(plan, &transport, 2);
+    CHECK(ret == ECAT_FAIL, "execute returned %d", ret);
+    check_responder(&resp, 2);
+    slave = motion_config_plan_get_slave(plan, 0);
+    CHECK(slave->state == CONFIG_SLAVE_DONE, "slave 0 in state %u", slave->state);
+    CHECK(resp.slaves[0].next == 2, "slave 0 got %u requests", resp.slaves[0].next);
+    slave = motion_config_plan_get_slave(plan, 1);
+    CHECK((slave->state == CONFIG_SLAVE_FAILED)&&(slave->error == CONFIG_ERROR_MISMATCH),
+        "slave 1 in state %u error %u", slave->state, slave->error);
+    motion_config_plan_free(plan);
+}
+
+int main(int argc, char **argv)
+{
+    const char* eni = TEST_SRCDIR "/../examples/ecatmotor/EtherCAT_ENI.xml";
+
+    if ((argc == 3)&&(!strcmp(argv[1], "-n"))) {
+        eni = argv[2];
+    } else if (argc != 1) {
+        printf("Usage: %s [-n enifile]\n", argv[0]);
+        return 1;
+    }
+    test_eni(eni);
+    test_parallel();
+    test_failure();
+    test_dependency();
+    test_steps();
+
+    printf("%s\n", failures ? "FAILED" : "PASSED");
+    return failures ? 1 : 0;
+}
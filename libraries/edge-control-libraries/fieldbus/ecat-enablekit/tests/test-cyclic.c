@@ -0,0 +1,386 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2025 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions
+// and limitations under the License.
+
+/**
+ *
+ * @file test-cyclic.c
+ *
+ * Runs the cyclic runner on a simulated clock, the hooks advance the clock
+ * by a scripted execution time to provoke overruns. The last test runs the
+ * thread on the real clock.
+ *
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <../libecat/motioncyclic.h>
+#include <../libecat/motionentry.h>
+
+#define PERIOD_NS       (1000000)
+#define MAX_CALLS       (4096)
+
+typedef struct{
+    int64_t now;
+    int64_t wake_latency;   /* added to every sleep */
+    int64_t poll_cost;      /* added to every read of the clock */
+} sim_clock_t;
+
+typedef struct{
+    sim_clock_t* clock;
+    int64_t exec_ns;        /* run time of a cycle */
+    int64_t slow_ns;        /* run time of the slow calls */
+    uint32_t slow_from;     /* calls [slow_from, slow_to) are slow */
+    uint32_t slow_to;
+    uint32_t stop_at;       /* call at which process stops the runner, 0 for none */
+    /* observed */
+    uint32_t phase;
+    uint32_t bad_order;
+    uint32_t receives;
+    uint32_t processes;
+    uint32_t sends;
+    motion_cyclic_info_t calls[MAX_CALLS];
+} app_t;
+
+static int failures;
+
+#define CHECK(cond, ...) do { \
+    if (!(cond)) { \
+        printf("FAIL %s:%d: ", __func__, __LINE__); \
+        printf(__VA_ARGS__); \
+        printf("\n"); \
+        failures++; \
+    } \
+} while (0)
+
+static int64_t sim_now(void* ctx)
+{
+    sim_clock_t* c = (sim_clock_t*)ctx;
+    int64_t t = c->now;
+
+    c->now += c->poll_cost;
+    return t;
+}
+
+static void sim_sleep_until(void* ctx, int64_t time)
+{
+    sim_clock_t* c = (sim_clock_t*)ctx;
+
+    if (time > c->now) {
+        c->now = time + c->wake_latency;
+    }
+}
+
+static int app_receive(void* arg, const motion_cyclic_info_t* info)
+{
+    app_t* app = (app_t*)arg;
+
+    if (app->phase != 0) {
+        app->bad_order++;
+    }
+    app->phase = 1;
+    if (app->receives < MAX_CALLS) {
+        app->calls[app->receives] = *info;
+    }
+    app->receives++;
+    return 0;
+}
+
+static int app_process(void* arg, const motion_cyclic_info_t* info)
+{
+    app_t* app = (app_t*)arg;
+    uint32_t call = app->processes++;
+
+    if (app->phase != 1) {
+        app->bad_order++;
+    }
+    app->phase = 2;
+    if ((call >= app->slow_from) && (call < app->slow_to)) {
+        app->clock->now += app->slow_ns;
+    } else {
+        app->clock->now += app->exec_ns;
+    }
+    if (app->stop_at && (call == app->stop_at)) {
+        app->phase = 0;
+        return 1;
+    }
+    return 0;
+}
+
+static int app_send(void* arg, const motion_cyclic_info_t* info)
+{
+    app_t* app = (app_t*)arg;
+
+    if (app->phase != 2) {
+        app->bad_order++;
+    }
+    app->phase = 0;
+    app->sends++;
+    return 0;
+}
+
+static motion_cyclic_t* setup(app_t* app, sim_clock_t* sim, motion_cyclic_clock_t* clock, uint8_t overrun)
+{
+    motion_cyclic_config_t config;
+
+    memset(app, 0, sizeof(app_t));
+    memset(sim, 0, sizeof(sim_clock_t));
+    sim->now = 123456789;
+    clock->now = sim_now;
+    clock->sleep_until = sim_sleep_until;
+    clock->ctx = sim;
+    app->clock = sim;
+    app->exec_ns = 200000;
+
+    motion_cyclic_config_init(&config, PERIOD_NS);
+    config.sched_policy = CYCLIC_SCHED_OTHER;
+    config.overrun = overrun;
+    config.receive = app_receive;
+    config.process = app_process;
+    config.send = app_send;
+    config.arg = app;
+    config.clock = clock;
+    return motion_cyclic_create(&config);
+}
+
+/* Deadlines stay on the grid and the cycle numbers follow the periods */
+static uint32_t check_grid(const motion_cyclic_t* runner, const app_t* app)
+{
+    uint32_t i, wrong = 0;
+
+    for (i = 0; i < app->receives && i < MAX_CALLS; i++) {
+        if ((app->calls[i].deadline - runner->start) != (int64_t)app->calls[i].cycle * PERIOD_NS) {
+            wrong++;
+        }
+        if (i && (app->calls[i].cycle - app->calls[i - 1].cycle
+            != app->calls[i - 1].period_ns / PERIOD_NS + app->calls[i].missed)) {
+            wrong++;
+        }
+    }
+    return wrong;
+}
+
+static void test_in_time(void)
+{
+    app_t app;
+    sim_clock_t sim;
+    motion_cyclic_clock_t clock;
+    motion_cyclic_t* runner = setup(&app, &sim, &clock, CYCLIC_OVERRUN_SKIP);
+    uint32_t i, late = 0;
+
+    CHECK(motion_cyclic_run(runner, 1000) == ECAT_OKAY, "run failed");
+    CHECK(app.receives == 1000 && app.processes == 1000 && app.sends == 1000, "hooks called %u/%u/%u times",
+        app.receives, app.processes, app.sends);
+    CHECK(!app.bad_order, "hooks out of order %u times", app.bad_order);
+    for (i = 0; i < 1000; i++) {
+        if ((app.calls[i].cycle != i) || (app.calls[i].wakeup != app.calls[i].deadline)) {
+            late++;
+        }
+    }
+    CHECK(!late, "%u cycles off the grid or late", late);
+    CHECK(!check_grid(runner, &app), "grid broken");
+    CHECK(runner->stats.overruns == 0 && runner->stats.missed == 0, "%lu overruns, %lu missed",
+        (unsigned long)runner->stats.overruns, (unsigned long)runner->stats.missed);
+    CHECK(runner->stats.exec_max == 200000, "exec max %ld", (long)runner->stats.exec_max);
+
+    /* a second run continues on the same grid */
+    CHECK(motion_cyclic_run(runner, 10) == ECAT_OKAY, "second run failed");
+    CHECK(app.calls[1009].cycle == 1009, "second run at cycle %lu", (unsigned long)app.calls[1009].cycle);
+    motion_cyclic_free(runner);
+}
+
+static void test_skip(void)
+{
+    app_t app;
+    sim_clock_t sim;
+    motion_cyclic_clock_t clock;
+    motion_cyclic_t* runner = setup(&app, &sim, &clock, CYCLIC_OVERRUN_SKIP);
+
+    app.slow_from = 100;
+    app.slow_to = 101;
+    app.slow_ns = 2500000;
+    motion_cyclic_run(runner, 200);
+    CHECK(app.calls[100].cycle == 100, "slow call at cycle %lu", (unsigned long)app.calls[100].cycle);
+    CHECK(app.calls[101].cycle == 103, "cycle after the overrun is %lu", (unsigned long)app.calls[101].cycle);
+    CHECK(app.calls[101].missed == 2, "%u deadlines dropped", app.calls[101].missed);
+    CHECK(app.calls[101].wakeup == app.calls[101].deadline, "late by %ld ns",
+        (long)(app.calls[101].wakeup - app.calls[101].deadline));
+    CHECK(!check_grid(runner, &app), "grid broken");
+    CHECK(runner->stats.overruns == 1 && runner->stats.missed == 2, "%lu overruns, %lu missed",
+        (unsigned long)runner->stats.overruns, (unsigned long)runner->stats.missed);
+    motion_cyclic_free(runner);
+}
+
+static void test_catch_up(void)
+{
+    app_t app;
+    sim_clock_t sim;
+    motion_cyclic_clock_t clock;
+    motion_cyclic_t* runner = setup(&app, &sim, &clock, CYCLIC_OVERRUN_CATCH_UP);
+    uint32_t i, missing = 0;
+
+    app.slow_from = 100;
+    app.slow_to = 101;
+    app.slow_ns = 2500000;
+    motion_cyclic_run(runner, 200);
+    for (i = 0; i < 200; i++) {
+        if (app.calls[i].cycle != i) {
+            missing++;
+        }
+    }
+    CHECK(!missing, "%u cycles missing", missing);
+    CHECK(app.calls[101].wakeup > app.calls[101].deadline, "cycle 101 not caught up");
+    CHECK(app.calls[102].wakeup > app.calls[102].deadline, "cycle 102 not caught up");
+    CHECK(app.calls[103].wakeup == app.calls[103].deadline, "cycle 103 late by %ld ns",
+        (long)(app.calls[103].wakeup - app.calls[103].deadline));
+    CHECK(!check_grid(runner, &app), "grid broken");
+    CHECK(runner->stats.missed == 0, "%lu missed", (unsigned long)runner->stats.missed);
+    motion_cyclic_free(runner);
+
+    /* more missed cycles than allowed are skipped */
+    runner = setup(&app, &sim, &clock, CYCLIC_OVERRUN_CATCH_UP);
+    runner->config.max_catch_up = 1;
+    app.slow_from = 100;
+    app.slow_to = 101;
+    app.slow_ns = 2500000;
+    motion_cyclic_run(runner, 200);
+    CHECK(app.calls[101].cycle == 103, "cycle after the overrun is %lu", (unsigned long)app.calls[101].cycle);
+    CHECK(!check_grid(runner, &app), "grid broken");
+    motion_cyclic_free(runner);
+}
+
+static void test_degrade(void)
+{
+    app_t app;
+    sim_clock_t sim;
+    motion_cyclic_clock_t clock;
+    motion_cyclic_t* runner = setup(&app, &sim, &clock, CYCLIC_OVERRUN_DEGRADE);
+    uint32_t i, degraded_at = 0, restored_at = 0;
+
+    runner->config.recover_after = 100;
+    app.slow_from = 100;
+    app.slow_to = 150;
+    app.slow_ns = 1500000;
+    motion_cyclic_run(runner, 400);
+    for (i = 1; i < 400; i++) {
+        if (!degraded_at && (app.calls[i].period_ns == 2 * PERIOD_NS)) {
+            degraded_at = i;
+        }
+        if (degraded_at && !restored_at && (app.calls[i].period_ns == PERIOD_NS)) {
+            restored_at = i;
+        }
+    }
+    CHECK(degraded_at == 103, "degraded at call %u", degraded_at);
+    CHECK(restored_at == 250, "restored at call %u", restored_at);
+    CHECK(runner->stats.overruns == 3, "%lu overruns", (unsigned long)runner->stats.overruns);
+    CHECK(!check_grid(runner, &app), "grid broken");
+    motion_cyclic_free(runner);
+
+    /* the period stops growing at the largest divider */
+    runner = setup(&app, &sim, &clock, CYCLIC_OVERRUN_DEGRADE);
+    app.slow_from = 0;
+    app.slow_to = 1000;
+    app.slow_ns = 20000000;
+    motion_cyclic_run(runner, 100);
+    CHECK(app.calls[99].period_ns == CYCLIC_DEFAULT_MAX_DIVIDER * PERIOD_NS, "period %u at the end",
+        app.calls[99].period_ns);
+    CHECK(!check_grid(runner, &app), "grid broken");
+    motion_cyclic_free(runner);
+}
+
+static void test_spin(void)
+{
+    app_t app;
+    sim_clock_t sim;
+    motion_cyclic_clock_t clock;
+    motion_cyclic_t* runner = setup(&app, &sim, &clock, CYCLIC_OVERRUN_SKIP);
+
+    sim.wake_latency = 30000;
+    sim.poll_cost = 100;
+    motion_cyclic_run(runner, 100);
+    CHECK(runner->stats.latency_min >= 30000, "latency %ld without spinning", (long)runner->stats.latency_min);
+    motion_cyclic_free(runner);
+
+    runner = setup(&app, &sim, &clock, CYCLIC_OVERRUN_SKIP);
+    runner->config.spin_ns = 50000;
+    sim.wake_latency = 30000;
+    sim.poll_cost = 100;
+    motion_cyclic_run(runner, 100);
+    CHECK(runner->stats.latency_max < 1000, "latency %ld with spinning", (long)runner->stats.latency_max);
+    CHECK(!runner->stats.overruns, "%lu overruns", (unsigned long)runner->stats.overruns);
+    motion_cyclic_free(runner);
+}
+
+static void test_stop(void)
+{
+    app_t app;
+    sim_clock_t sim;
+    motion_cyclic_clock_t clock;
+    motion_cyclic_t* runner = setup(&app, &sim, &clock, CYCLIC_OVERRUN_SKIP);
+    motion_cyclic_config_t config;
+
+    app.stop_at = 10;
+    CHECK(motion_cyclic_run(runner, 100) == ECAT_FAIL, "stop not reported");
+    CHECK(app.receives == 11 && app.sends == 10, "hooks called %u/%u times after the stop",
+        app.receives, app.sends);
+    motion_cyclic_free(runner);
+
+    motion_cyclic_config_init(&config, PERIOD_NS);
+    config.spin_ns = PERIOD_NS;
+    CHECK(!motion_cyclic_create(&config), "spin time longer than the period accepted");
+}
+
+static int thread_process(void* arg, const motion_cyclic_info_t* info)
+{
+    (*(volatile uint32_t*)arg)++;
+    return 0;
+}
+
+static void test_thread(void)
+{
+    motion_cyclic_config_t config;
+    motion_cyclic_t* runner;
+    volatile uint32_t cycles = 0;
+
+    motion_cyclic_config_init(&config, PERIOD_NS);
+    config.sched_policy = CYCLIC_SCHED_OTHER;
+    config.spin_ns = 20000;
+    config.process = thread_process;
+    config.arg = (void*)&cycles;
+    runner = motion_cyclic_create(&config);
+    CHECK(motion_cyclic_start(runner) == ECAT_OKAY, "start failed");
+    usleep(100000);
+    CHECK(motion_cyclic_stop(runner) == ECAT_OKAY, "stop failed");
+    CHECK(cycles >= 20 && cycles <= 110, "%u cycles in 100 ms", cycles);
+    CHECK(runner->stats.latency_min >= 0, "woke %ld ns early", (long)-runner->stats.latency_min);
+    printf("thread: %u cycles, latency %ld..%ld ns, exec max %ld ns\n", cycles,
+        (long)runner->stats.latency_min, (long)runner->stats.latency_max, (long)runner->stats.exec_max);
+    motion_cyclic_free(runner);
+}
+
+int main(int argc, char **argv)
+{
+    test_in_time();
+    test_skip();
+    test_catch_up();
+    test_degrade();
+    test_spin();
+    test_stop();
+    test_thread();
+
+    printf("%s\n", failures ? "FAILED" : "PASSED");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,499 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2025 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions
+// and limitations under the License.
+
+/**
+ *
+ * @file test-esicatalog.c
+ *
+ * Builds the ESI catalogue over a copy of tests/esi and checks it against
+ * the slaves of the example ENI files, then checks that the index is reused
+ * and refreshed, and times a lookup in a large ESI file against parsing the
+ * whole file.
+ *
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <libxml/parser.h>
+#include <libxml/tree.h>
+#include <../esiconfig/esiconfig.h>
+#include <../esiconfig/esicatalog.h>
+
+/* Source directory of the tests, the build passes it so that the fixtures are
+ * found from any directory */
+#ifndef TEST_SRCDIR
+#define TEST_SRCDIR "tests"
+#endif
+
+#define SERVO_VENDOR    0x0000066F
+#define SERVO_PRODUCT   0x613C0005
+#define LARGE_DEVICES   500
+
+static int failures;
+
+#define CHECK(cond, ...) do { \
+    if (!(cond)) { \
+        printf("FAIL %s:%d: ", __func__, __LINE__); \
+        printf(__VA_ARGS__); \
+        printf("\n"); \
+        failures++; \
+    } \
+} while (0)
+
+static char* read_file(const char* path, size_t* len)
+{
+    FILE* fp = fopen(path, "rb");
+    char* buf;
+    long size;
+
+    if (!fp) {
+        return NULL;
+    }
+    fseek(fp, 0, SEEK_END);
+    size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    buf = malloc(size + 1);
+    if (buf && (fread(buf, 1, size, fp) != (size_t)size)) {
+        free(buf);
+        buf = NULL;
+    }
+    if (buf) {
+        buf[size] = '\0';
+        *len = size;
+    }
+    fclose(fp);
+    return buf;
+}
+
+static int write_file(const char* path, const char* buf, size_t len)
+{
+    FILE* fp = fopen(path, "wb");
+
+    if (!fp) {
+        return -1;
+    }
+    fwrite(buf, 1, len, fp);
+    return fclose(fp);
+}
+
+static int copy_file(const char* src_dir, const char* dst_dir, const char* name)
+{
+    char path[512];
+    size_t len;
+    char* buf;
+    int ret;
+
+    snprintf(path, sizeof(path), "%s/%s", src_dir, name);
+    buf = read_file(path, &len);
+    if (!buf) {
+        return -1;
+    }
+    snprintf(path, sizeof(path), "%s/%s", dst_dir, name);
+    ret = write_file(path, buf, len);
+    free(buf);
+    return ret;
+}
+
+static double now_ms(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static xmlNodePtr child_named(xmlNodePtr node, const char* name)
+{
+    for (node = node ? node->children : NULL; node; node = node->next) {
+        if ((node->type == XML_ELEMENT_NODE) && !xmlStrcmp(node->name, BAD_CAST name)) {
+            return node;
+        }
+    }
+    return NULL;
+}
+
+static uint32_t child_number(xmlNodePtr node, const char* name)
+{
+    xmlChar* key;
+    uint32_t val = 0;
+
+    node = child_named(node, name);
+    if (node) {
+        key = xmlNodeGetContent(node);
+        if (key[0] == '#') {
+            val = strtoul((const char*)key + 2, NULL, 16);
+        } else {
+            val = strtoul((const char*)key, NULL, 10);
+        }
+        xmlFree(key);
+    }
+    return val;
+}
+
+static const esi_catalog_pdo* find_pdo(const esi_catalog_device* device, uint16_t index)
+{
+    uint16_t i;
+
+    for (i = 0; i < device->n_pdos; i++) {
+        if (device->pdos[i].index == index) {
+            return &device->pdos[i];
+        }
+    }
+    return NULL;
+}
+
+/* Every slave of the ENI file is in the catalogue with the same PDOs */
+static void test_eni(ecat_esi_catalog* catalog, const char* eni)
+{
+    xmlDocPtr doc = xmlReadFile(eni, NULL, XML_PARSE_NONET);
+    xmlNodePtr slave, info, pd, node, pdo_node;
+    const esi_catalog_device* device;
+    const esi_catalog_pdo* pdo;
+    uint32_t vendor, product, revision, n_slaves = 0, n_pdos, sm;
+    xmlChar* key;
+    char name[64];
+
+    CHECK(doc, "cannot read %s", eni);
+    if (!doc) {
+        return;
+    }
+    for (slave = child_named(child_named(xmlDocGetRootElement(doc), "Config"), "Slave"); slave; slave = slave->next) {
+        if ((slave->type != XML_ELEMENT_NODE) || xmlStrcmp(slave->name, BAD_CAST"Slave")) {
+            continue;
+        }
+        n_slaves++;
+        info = child_named(slave, "Info");
+        vendor = child_number(info, "VendorId");
+        product = child_number(info, "ProductCode");
+        revision = child_number(info, "RevisionNo");
+        device = ecat_esi_catalog_find(catalog, vendor, product, revision);
+        CHECK(device, "%s: slave %#x/%#x/%#x not in the catalogue", eni, vendor, product, revision);
+        if (!device) {
+            continue;
+        }
+        CHECK(device->vendor_id == vendor && device->revision_no == revision, "%s: found %#x rev %#x", eni,
+            device->vendor_id, device->revision_no);
+        key = xmlNodeGetContent(child_named(info, "Name"));
+        snprintf(name, sizeof(name), "%s", (const char*)key);
+        xmlFree(key);
+        CHECK(!strncmp(name, device->name, strlen(device->name)), "%s: slave %s found as %s", eni, name, device->name);
+
+        pd = child_named(slave, "ProcessData");
+        n_pdos = 0;
+        for (node = pd ? pd->children : NULL; node; node = node->next) {
+            if (node->type != XML_ELEMENT_NODE) {
+                continue;
+            }
+            if (!xmlStrcmp(node->name, BAD_CAST"RxPdo") || !xmlStrcmp(node->name, BAD_CAST"TxPdo")) {
+                n_pdos++;
+                pdo = find_pdo(device, child_number(node, "Index"));
+                CHECK(pdo, "%s: PDO %#x missing", eni, child_number(node, "Index"));
+                if (!pdo) {
+                    continue;
+                }
+                CHECK(pdo->direction == ((node->name[0] == 'T') ? EC_DIR_INPUT : EC_DIR_OUTPUT),
+                    "%s: PDO %#x direction", eni, pdo->index);
+                key = xmlGetProp(node, BAD_CAST"Sm");
+                sm = key ? (uint32_t)atoi((const char*)key) : ESI_CATALOG_NO_SM;
+                xmlFree(key);
+                CHECK(pdo->sm_id == sm, "%s: PDO %#x in Sm %u, ENI says %u", eni, pdo->index, pdo->sm_id, sm);
+                sm = 0;
+                for (pdo_node = node->children; pdo_node; pdo_node = pdo_node->next) {
+                    sm += (pdo_node->type == XML_ELEMENT_NODE) && !xmlStrcmp(pdo_node->name, BAD_CAST"Entry");
+                }
+                CHECK(pdo->n_entries == sm, "%s: PDO %#x has %u entries, ENI %u", eni, pdo->index,
+                    pdo->n_entries, sm);
+            } else if (!xmlStrncmp(node->name, BAD_CAST"Sm", 2) && (node->name[2] >= '0') && (node->name[2] <= '9')) {
+                sm = atoi((const char*)node->name + 2);
+                n_pdos = 0;
+                for (pdo_node = node->children; pdo_node; pdo_node = pdo_node->next) {
+                    n_pdos += (pdo_node->type == XML_ELEMENT_NODE) && !xmlStrcmp(pdo_node->name, BAD_CAST"Pdo");
+                }
+                CHECK(ecat_esi_catalog_get_pdo_size_by_sm_id(device, sm) == n_pdos, "%s: Sm%u has %u PDOs, ENI %u",
+                    eni, sm, ecat_esi_catalog_get_pdo_size_by_sm_id(device, sm), n_pdos);
+                n_pdos = 0;
+            }
+        }
+        CHECK(device->n_pdos >= n_pdos, "%s: %u PDOs, ENI %u", eni, device->n_pdos, n_pdos);
+    }
+    CHECK(n_slaves, "no slave in %s", eni);
+    xmlFreeDoc(doc);
+}
+
+static void test_content(ecat_esi_catalog* catalog)
+{
+    const esi_catalog_device* device;
+    const esi_catalog_device* again;
+    uint32_t parsed;
+    uint16_t i, gaps = 0;
+
+    device = ecat_esi_catalog_find(catalog, SERVO_VENDOR, SERVO_PRODUCT, ESI_CATALOG_ANY_REVISION);
+    CHECK(device && device->revision_no == 0x00020000, "highest revision not found");
+    device = ecat_esi_catalog_find(catalog, SERVO_VENDOR, SERVO_PRODUCT, 0x00010000);
+    CHECK(device, "revision 0x10000 not found");
+    if (!device) {
+        return;
+    }
+    parsed = catalog->n_parsed;
+    again = ecat_esi_catalog_find(catalog, SERVO_VENDOR, SERVO_PRODUCT, 0x00010000);
+    CHECK(again == device && catalog->n_parsed == parsed, "device parsed again");
+    CHECK(!ecat_esi_catalog_find(catalog, SERVO_VENDOR, SERVO_PRODUCT, 0x00030000), "unknown revision found");
+    CHECK(!ecat_esi_catalog_find(catalog, SERVO_VENDOR, 0x613C0099, ESI_CATALOG_ANY_REVISION), "unknown product found");
+    CHECK(!ecat_esi_catalog_find(catalog, 0x1234, SERVO_PRODUCT, ESI_CATALOG_ANY_REVISION), "unknown vendor found");
+
+    CHECK(!strcmp(device->name, "MADLT15BF"), "name %s", device->name);
+    CHECK(device->n_pdos == 8 && device->n_sms == 4 && device->n_opmodes == 2, "%u PDOs, %u Sms, %u opmodes",
+        device->n_pdos, device->n_sms, device->n_opmodes);
+    CHECK(device->sms[2].start_address == 0x1400 && device->sms[2].control_byte == 0x64
+        && device->sms[3].default_size == 23, "Sm content");
+    CHECK(device->opmodes[0].assign_activate == 0x0300 && !strcmp(device->opmodes[0].name, "DC"), "DC opmode");
+    CHECK(device->request_timeout == 100 && device->response_timeout == 2000, "mailbox timeouts %u/%u",
+        device->request_timeout, device->response_timeout);
+    CHECK(ecat_esi_catalog_get_sm_size(device) == 4, "sm size %u", ecat_esi_catalog_get_sm_size(device));
+    for (i = 1; i < device->n_pdos; i++) {
+        if (device->pdos[i].first_entry != device->pdos[i - 1].first_entry + device->pdos[i - 1].n_entries) {
+            gaps++;
+        }
+    }
+    CHECK(!gaps && device->pdos[0].first_entry == 0, "entries not contiguous");
+    CHECK(device->entries[device->pdos[0].first_entry + 1].index == 0x6041
+        && device->entries[device->pdos[0].first_entry + 1].bitLen == 16, "second entry of PDO %#x",
+        device->pdos[0].index);
+}
+
+/* The indexed byte ranges hold exactly the device elements */
+static void test_ranges(ecat_esi_catalog* catalog)
+{
+    char path[512];
+    uint32_t i, f, wrong = 0;
+    size_t len;
+    char* buf;
+
+    for (f = 0; f < catalog->n_files; f++) {
+        snprintf(path, sizeof(path), "%s/%s", catalog->dir, catalog->files[f].name);
+        buf = read_file(path, &len);
+        CHECK(buf, "cannot read %s", path);
+        for (i = 0; buf && (i < catalog->n_items); i++) {
+            const esi_catalog_item* item = &catalog->items[i];
+
+            if (item->file != f) {
+                continue;
+            }
+            if ((item->end > (int64_t)len) || (item->start + 18 > item->end) || strncmp(buf + item->start, "<Device", 7)
+                || strncmp(buf + item->end - 9, "</Device>", 9)) {
+                wrong++;
+            }
+        }
+        free(buf);
+    }
+    CHECK(!wrong, "%u device ranges wrong", wrong);
+}
+
+static void test_index(const char* dir)
+{
+    static const char extra[] =
+        "<?xml version=\"1.0\"?>\n<EtherCATInfo><Vendor><Id>#x99</Id></Vendor><Descriptions><Devices>\n"
+        "<Device><Type ProductCode=\"#x5\" RevisionNo=\"#x1\">Extra</Type><Sm StartAddress=\"#x1000\"/>"
+        "</Device></Devices></Descriptions></EtherCATInfo>\n";
+    ecat_esi_catalog* catalog;
+    const esi_catalog_device* device;
+    char path[512];
+    uint32_t i;
+
+    catalog = ecat_esi_catalog_open(dir, NULL);
+    CHECK(catalog && catalog->n_scanned == 0 && catalog->n_items == 7, "index not reused");
+    if (catalog) {
+        /* a stale range falls back to streaming the file */
+        for (i = 0; i < catalog->n_items; i++) {
+            catalog->items[i].start += 3;
+        }
+        device = ecat_esi_catalog_find(catalog, SERVO_VENDOR, SERVO_PRODUCT, 0x00010000);
+        CHECK(device && device->n_pdos == 8, "device not found through the fallback");
+    }
+    ecat_esi_catalog_close(catalog);
+
+    snprintf(path, sizeof(path), "%s/extra.xml", dir);
+    write_file(path, extra, strlen(extra));
+    catalog = ecat_esi_catalog_open(dir, NULL);
+    CHECK(catalog && catalog->n_scanned == 1 && catalog->n_items == 8, "added file not indexed");
+    CHECK(catalog && ecat_esi_catalog_find(catalog, 0x99, 0x5, 0x1), "added device not found");
+    ecat_esi_catalog_close(catalog);
+
+    unlink(path);
+    catalog = ecat_esi_catalog_open(dir, NULL);
+    CHECK(catalog && catalog->n_scanned == 0 && catalog->n_items == 7, "removed file still indexed");
+    CHECK(catalog && !ecat_esi_catalog_find(catalog, 0x99, 0x5, 0x1), "removed device found");
+    ecat_esi_catalog_close(catalog);
+    catalog = ecat_esi_catalog_open(dir, NULL);
+    CHECK(catalog && catalog->n_scanned == 0 && catalog->n_items == 7, "index not rewritten");
+    ecat_esi_catalog_close(catalog);
+}
+
+/* One file with LARGE_DEVICES copies of the servo device, each its own product */
+static int write_large(const char* src_dir, const char* dir)
+{
+    char path[512];
+    char code[16];
+    char* esi;
+    char* first;
+    char* second;
+    char* end;
+    char* type;
+    size_t len;
+    FILE* fp;
+    int i;
+
+    snprintf(path, sizeof(path), "%s/servo_drives.xml", src_dir);
+    esi = read_file(path, &len);
+    if (!esi) {
+        return -1;
+    }
+    first = strstr(esi, "\t\t\t<Device");
+    second = first ? strstr(first + 1, "\t\t\t<Device") : NULL;
+    end = second ? strstr(second, "</Device>\n") : NULL;
+    type = second ? strstr(second, "ProductCode=\"") : NULL;
+    snprintf(path, sizeof(path), "%s/large.xml", dir);
+    fp = fopen(path, "w");
+    if (!end || !type || !fp) {
+        free(esi);
+        return -1;
+    }
+    type += strlen("ProductCode=\"");
+    end += strlen("</Device>\n");
+    fwrite(esi, 1, first - esi, fp);
+    for (i = 0; i < LARGE_DEVICES; i++) {
+        snprintf(code, sizeof(code), "#x%08X", 0x70000000 + i);
+        fwrite(second, 1, type - second, fp);
+        fputs(code, fp);
+        fwrite(type + strlen(code), 1, end - type - strlen(code), fp);
+    }
+    fputs(strstr(end, "\t\t</Devices>"), fp);
+    fclose(fp);
+    free(esi);
+    return 0;
+}
+
+static void test_large(const char* src_dir, const char* dir)
+{
+    ecat_esi_catalog* catalog;
+    const esi_catalog_device* device;
+    ecat_slave_esi* esi;
+    char path[512];
+    double t0, full, build, open_ms, lookup;
+
+    CHECK(!write_large(src_dir, dir), "cannot write the large ESI file");
+    snprintf(path, sizeof(path), "%s/large.xml", dir);
+
+    t0 = now_ms();
+    esi = ecat_load_slave_profile(path);
+    full = now_ms() - t0;
+    CHECK(esi, "profile not loaded");
+    ecat_free_esi_profile(esi);
+
+    t0 = now_ms();
+    catalog = ecat_esi_catalog_open(dir, NULL);
+    build = now_ms() - t0;
+    CHECK(catalog && catalog->n_items == LARGE_DEVICES, "%u devices indexed", catalog ? catalog->n_items : 0);
+    ecat_esi_catalog_close(catalog);
+
+    t0 = now_ms();
+    catalog = ecat_esi_catalog_open(dir, NULL);
+    open_ms = now_ms() - t0;
+    t0 = now_ms();
+    device = ecat_esi_catalog_find(catalog, SERVO_VENDOR, 0x70000000 + LARGE_DEVICES - 1, 0x00010000);
+    lookup = now_ms() - t0;
+    CHECK(device && device->n_pdos == 8, "last device not parsed");
+    CHECK(catalog->n_parsed == 1, "%u devices parsed", catalog->n_parsed);
+    ecat_esi_catalog_close(catalog);
+
+    printf("%u devices: full parse %.2f ms, index build %.2f ms, index open %.3f ms, lookup %.2f ms\n",
+        LARGE_DEVICES, full, build, open_ms, lookup);
+}
+
+static void cleanup(const char* dir)
+{
+    static const char* names[] = {"servo_drives.xml", "digital_io.xml", "large.xml", ESI_CATALOG_INDEX_NAME};
+    char path[512];
+    unsigned int i;
+
+    for (i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        snprintf(path, sizeof(path), "%s/%s", dir, names[i]);
+        unlink(path);
+    }
+    rmdir(dir);
+}
+
+int main(int argc, char **argv)
+{
+    const char* src_dir = TEST_SRCDIR "/esi";
+    const char* enis[8] = {TEST_SRCDIR "/../examples/ecatmotor/EtherCAT_ENI.xml",
+        TEST_SRCDIR "/../examples/ecatdio/EtherCAT_ENI.xml"};
+    int n_enis = 2;
+    int eni_given = 0;
+    char dir[] = "/tmp/esicatalog.XXXXXX";
+    char large_dir[] = "/tmp/esicatalog.XXXXXX";
+    ecat_esi_catalog* catalog;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-d") && (i + 1 < argc)) {
+            src_dir = argv[++i];
+        } else if (!strcmp(argv[i], "-n") && (i + 1 < argc)) {
+            if (!eni_given) {
+                n_enis = 0;
+                eni_given = 1;
+            }
+            i++;
+            if (n_enis < 8) {
+                enis[n_enis++] = argv[i];
+            }
+        } else {
+            printf("Usage: %s [-d esidir] [-n enifile]...\n", argv[0]);
+            return 1;
+        }
+    }
+    if (!mkdtemp(dir) || !mkdtemp(large_dir)) {
+        printf("cannot create a temporary directory\n");
+        return 1;
+    }
+    if (copy_file(src_dir, dir, "servo_drives.xml") || copy_file(src_dir, dir, "digital_io.xml")) {
+        printf("cannot copy the ESI files of %s\n", src_dir);
+        cleanup(dir);
+        rmdir(large_dir);
+        return 1;
+    }
+
+    catalog = ecat_esi_catalog_open(dir, NULL);
+    CHECK(catalog && catalog->n_files == 2 && catalog->n_scanned == 2 && catalog->n_items == 7,
+        "catalogue of %s not built", dir);
+    if (catalog) {
+        for (i = 0; i < n_enis; i++) {
+            test_eni(catalog, enis[i]);
+        }
+        test_content(catalog);
+        test_ranges(catalog);
+        ecat_esi_catalog_close(catalog);
+    }
+    test_index(dir);
+    test_large(src_dir, large_dir);
+    cleanup(dir);
+    cleanup(large_dir);
+
+    printf("%s\n", failures ? "FAILED" : "PASSED");
+    return failures ? 1 : 0;
+}
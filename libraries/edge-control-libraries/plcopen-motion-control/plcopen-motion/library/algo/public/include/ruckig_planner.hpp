@@ -28,6 +28,15 @@ public:
   double* getWaypoint(double t) override;
   void setFrequency(double f) override;
 
+  /**
+   * @brief Ruckig steps its own time and ignores t of getWaypoint(), so a
+   * time scaled profile advances by the cycle time times scale per waypoint.
+   * Velocity and acceleration stay those of the unscaled profile.
+   */
+  void setTimeScale(double scale);
+
+  double cycle_time_ = RUCKIG_DEFAULT_FREQUENCY;
+  double time_scale_ = 1;
   ruckig::Ruckig<RUCKIG_AXIS_NUM> otg_ =
       ruckig::Ruckig<RUCKIG_AXIS_NUM>(RUCKIG_DEFAULT_FREQUENCY);
   ruckig::InputParameter<RUCKIG_AXIS_NUM> input_;
@@ -63,7 +63,14 @@ double* RuckigPlanner::getWaypoint(double t)
 
 void RuckigPlanner::setFrequency(double f)
 {
-  otg_.delta_time = 1.0 / f;
+  cycle_time_     = 1.0 / f;
+  otg_.delta_time = cycle_time_ * time_scale_;
+}
+
+void RuckigPlanner::setTimeScale(double scale)
+{
+  time_scale_     = scale;
+  otg_.delta_time = cycle_time_ * time_scale_;
 }
 
 }  // namespace trajectory_processing
@@ -14,8 +14,11 @@
 #include <fb/common/include/servo.hpp>
 #include <queue>
 #include <fb/common/include/motion_kernel.hpp>
+#include <fb/common/include/axis_snapshot.hpp>
 
 #define NODE_BUFFER_MAX_SIZE 10
+// One planner for the motion queue front, one for the superimposed motion
+#define PLANNER_POOL_SIZE 2
 
 namespace RTmotion
 {
@@ -46,11 +49,27 @@ struct AxisConfig
   mcLREAL pos_positive_limit_     = 5000.0;
   mcLREAL pos_negative_limit_     = 5000.0;
   mcLREAL frequency_              = 1000.0;
+  // Apply override changes by time scaling the active move when its limits
+  // allow it, instead of replanning it
+  mcBOOL override_time_scaling_   = mcFALSE;
+  mcLREAL override_scale_rate_    = 1.0;   // Max time scale change per second
+  mcLREAL override_scale_acc_     = 10.0;  // Max scale rate change per second^2
+  // Number of queued blending moves planned together, 0 plans them pairwise
+  mcUSINT look_ahead_depth_       = 0;
   AxisParamInfo* param_table_     = nullptr;
   mcUINT param_table_num_         = 0;
   AxisCheckDoneFactor factor_;
 };
 
+struct AxisFootprint
+{
+  mcUDINT axis_;      // sizeof(Axis), everything an axis owns in place
+  mcUDINT node_;      // One execution node
+  mcUDINT nodes_;     // Execution node buffer
+  mcUDINT planner_;   // One trajectory planner
+  mcUDINT planners_;  // Trajectory planner pool
+};
+
 class Axis
 {
 public:
@@ -162,7 +181,25 @@ public:
   mcLREAL getMoveSupCoveredDistance();
   void replanUnderlyingMotion();
 
+  /**
+   * @brief Memory held by one axis, e.g. to size a cache-locked region for
+   * a configuration with many axes.
+   */
+  static AxisFootprint getFootprint();
+
+  /**
+   * @brief Publish the axis state to a snapshot table slot at the end of each
+   * runCycle(). The axis must be the only writer of the slot, copies of the
+   * axis are not bound to it.
+   * @param table Snapshot table, nullptr to stop publishing
+   * @param index Slot of this axis in the table
+   */
+  void setSnapshotTable(AxisSnapshotTable* table, mcUDINT index);
+
 private:
+  void bindNodePlanners();
+  void publishSnapshot();
+
   mcUSINT axis_id_;
   mcLREAL axis_pos_;
   mcLREAL axis_vel_;
@@ -219,6 +256,9 @@ private:
 
   mcUSINT node_num_;  // size of execution node queue in motion kernel
   ExecutionNode node_buffer_[NODE_BUFFER_MAX_SIZE];  // execution node pool
+  // Only the queue front and the superimposed node are executed in a cycle,
+  // so the nodes share these planners instead of embedding one each
+  trajectory_processing::AxisPlanner planner_pool_[PLANNER_POOL_SIZE];
   ExecutionNode* it_;
 
   mcBOOL axis_home_abs_switch_active_;
@@ -228,6 +268,9 @@ private:
   mcBOOL axis_has_warning_;
   // ExecutionNode of move superimposed FB
   ExecutionNode* superimposed_node_ptr_ = nullptr;
+  // State snapshot published for non-RT readers
+  AxisSnapshotTable* snapshot_table_ = nullptr;
+  mcUDINT snapshot_index_            = 0;
 };
 
 typedef Axis* AXIS_REF;
@@ -0,0 +1,104 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2025 Intel Corporation
+
+/**
+ * @file axis_snapshot.hpp
+ *
+ * Maintainer: Yu Yan <yu.yan@intel.com>
+ *
+ */
+
+#pragma once
+
+#include <fb/common/include/global.hpp>
+#include <atomic>
+#include <type_traits>
+
+#define AXIS_SNAPSHOT_MAX_NUM 256  // Axes per snapshot table
+#define AXIS_SNAPSHOT_ALIGN 64     // Cache line size
+#define AXIS_SNAPSHOT_RETRY 64     // Default read attempts while written
+
+namespace RTmotion
+{
+/**
+ * @brief State of one axis at the end of a cycle, in user units.
+ */
+struct AxisSnapshot
+{
+  mcULINT cycle_;           // Axis cycle count when published
+  mcLREAL stamp_;           // Axis time stamp in seconds
+  mcLREAL pos_;             // Actual position
+  mcLREAL vel_;             // Actual velocity
+  mcLREAL acc_;             // Actual acceleration
+  mcLREAL torque_;          // Actual torque
+  mcLREAL pos_cmd_;         // Commanded position
+  mcLREAL vel_cmd_;         // Commanded velocity
+  mcLREAL acc_cmd_;         // Commanded acceleration
+  MC_AXIS_STATES state_;    // PLCopen axis state
+  MC_ERROR_CODE error_;     // Axis error, mcErrorCodeGood if none
+  MC_MOTION_MODE motion_;   // Motion commanding the axis, or mcNoMoveType
+  mcUSINT queued_;          // Motions in the queue, including the active one
+  mcUSINT axis_id_;         // Axis id
+  mcBOOL power_;            // Power status
+  mcBOOL homed_;            // Home state
+  mcBOOL warning_;          // Axis warning
+};
+
+static_assert(std::is_trivially_copyable<AxisSnapshot>::value,
+              "AxisSnapshot is copied word by word");
+
+/**
+ * @brief Seqlock protected table of axis state snapshots.
+ *
+ * Each axis publishes to its own slot once per cycle and never waits for a
+ * reader. Readers copy a slot and retry if the axis wrote it meanwhile, so
+ * any number of non-RT readers (HMI, SCADA, logging) can poll all axes
+ * without FBs in the RT cycle and without perturbing it.
+ *
+ * Slots are cache-line aligned so axes publishing on different cores do not
+ * share lines. The table holds no pointers and only lock-free atomics, so it
+ * can be constructed in shared memory and read from another process.
+ */
+class AxisSnapshotTable
+{
+public:
+  AxisSnapshotTable();
+
+  /**
+   * @brief Publish a snapshot, called by the axis owning the slot only.
+   * @param index Slot index, below AXIS_SNAPSHOT_MAX_NUM
+   */
+  void publish(mcUDINT index, const AxisSnapshot& snapshot);
+
+  /**
+   * @brief Copy a consistent snapshot of a slot.
+   * @param retry Read attempts if the slot is written during the copy
+   * @return mcFALSE if the slot was never published, the index is invalid or
+   * no attempt was consistent
+   */
+  mcBOOL read(mcUDINT index, AxisSnapshot& snapshot,
+              mcUDINT retry = AXIS_SNAPSHOT_RETRY) const;
+
+  /**
+   * @brief Number of snapshots published to a slot so far, a reader can skip
+   * slots whose version did not change since its last read.
+   */
+  mcULINT getVersion(mcUDINT index) const;
+
+private:
+  static constexpr size_t WORD_NUM =
+      (sizeof(AxisSnapshot) + sizeof(mcULINT) - 1) / sizeof(mcULINT);
+
+  struct alignas(AXIS_SNAPSHOT_ALIGN) Slot
+  {
+    std::atomic<mcULINT> sequence_;  // Odd while the slot is written
+    std::atomic<mcULINT> data_[WORD_NUM];
+  };
+
+  static_assert(std::atomic<mcULINT>::is_always_lock_free,
+                "Snapshot table must be usable from shared memory");
+
+  Slot slots_[AXIS_SNAPSHOT_MAX_NUM];
+};
+
+}  // namespace RTmotion
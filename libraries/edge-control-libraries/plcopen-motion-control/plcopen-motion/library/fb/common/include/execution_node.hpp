@@ -44,6 +44,24 @@ public:
 
   void setFrequency(mcLREAL f);
 
+  /**
+   * @brief Bind the node to a trajectory planner owned by its axis. Nodes
+   * that never run at the same time share one planner, each node replans
+   * before it executes.
+   * @param planner Planner used by onExecution(), nullptr to unbind
+   */
+  void setPlanner(trajectory_processing::AxisPlanner* planner);
+
+  /**
+   * @brief Enable override by time scaling. The scale follows its target with
+   * bounded rate and bounded rate change, which keeps the commanded jerk
+   * bounded during the transition.
+   * @param enable Apply override changes by time scaling when possible
+   * @param rate Max change of the time scale per second
+   * @param acc Max change of the time scale rate per second^2
+   */
+  void setTimeScaling(mcBOOL enable, mcLREAL rate, mcLREAL acc);
+
   void reset();
   void restart();
 
@@ -64,10 +82,15 @@ public:
   // Functions to address outputs
   MC_BUFFER_MODE getBufferMode();
   MC_MOTION_MODE getMotionMode();
+  mcLREAL getStartPos();
+  mcLREAL getStartVel();
   mcLREAL getEndPos();
   mcLREAL getEndVel();
   mcLREAL getEndAcc();
   mcLREAL getVelocity();
+  mcLREAL getAcceleration();
+  mcLREAL getDeceleration();
+  mcLREAL getJerk();
 
   void getCommands(mcLREAL* pos_cmd, mcLREAL* vel_cmd, mcLREAL* acc_cmd);
 
@@ -89,6 +112,16 @@ public:
 
   virtual void updateOverrideFactors(OverrideFactors& override_factors);
 
+  /**
+   * @brief Apply new override factors to the active move by time scaling its
+   * profile, which costs O(1) per cycle instead of a replan.
+   * @return mcFALSE if time scaling is disabled, not applicable to the motion
+   * mode, or the scaled profile would violate the new limits. The node has to
+   * be replanned with updateOverrideFactors() then.
+   */
+  mcBOOL scaleOverrideFactors(const OverrideFactors& override_factors);
+  mcLREAL getTimeScale();
+
   void setPlannerStartTime(mcLREAL t);
 
   MC_ERROR_CODE changeAxisStates(MC_AXIS_STATES* current_state,
@@ -138,14 +171,24 @@ protected:
 
   mcLREAL node_freq_;
   mcLREAL node_delta_time_;
-  mcLREAL node_active_time_;
-
-  // Trajectory generator variables
-  trajectory_processing::AxisPlanner planner_;
+  mcLREAL node_active_time_;  // Profile time, advanced by delta_time * scale
+
+  // Time scaling of the active profile for override changes
+  mcBOOL time_scaling_;
+  mcLREAL time_scale_;
+  mcLREAL time_scale_rate_;
+  mcLREAL time_scale_target_;
+  mcLREAL time_scale_rate_max_;
+  mcLREAL time_scale_acc_max_;
+  mcLREAL time_scale_acc_lim_;  // Acceleration limit of the scaled profile
+
+  // Trajectory generator variables, the planner is owned by the axis
+  trajectory_processing::AxisPlanner* planner_;
   PLANNER_TYPE planner_type_;
 
 private:
   void copyMemberVar(const ExecutionNode& node);
+  void stepTimeScale();
 };
 
 }  // namespace RTmotion
@@ -14,6 +14,8 @@
 #include <queue>
 #include <fb/common/include/execution_node.hpp>
 
+#define LOOK_AHEAD_MAX_DEPTH 16
+
 namespace RTmotion
 {
 class ExecutionNode;
@@ -40,6 +42,28 @@ public:
 
   std::deque<ExecutionNode*>& getQueuedMotions();
 
+  /**
+   * @brief Node whose commands drive the axis, the queue front or else the
+   * node held after it is done. nullptr if there is none.
+   */
+  ExecutionNode* getCommandingNode();
+
+  /**
+   * @brief Set how many queued moves the look-ahead plans over when a
+   * blending or buffered move is added. Depth 0 keeps pairwise blending, only
+   * the end velocity of the previous move is set.
+   * @param depth Number of moves, limited to LOOK_AHEAD_MAX_DEPTH
+   */
+  void setLookAheadDepth(mcUSINT depth);
+  mcUSINT getLookAheadDepth();
+
+  /**
+   * @brief Plan the junction velocities of the moves added since the last
+   * call. Runs at most one look-ahead pass, called by runCycle() before the
+   * queue front is processed.
+   */
+  void updateLookAhead();
+
   void getCommands(mcLREAL* pos_cmd, mcLREAL* vel_cmd, mcLREAL* acc_cmd);
 
   void setAllFBsAborted();
@@ -57,7 +81,12 @@ public:
                             mcLREAL current_vel, mcLREAL current_acc);
 
 private:
+  mcLREAL getBlendingVelocity(ExecutionNode* prev, ExecutionNode* next);
+  void planLookAhead();
+
   std::deque<ExecutionNode*> fb_queue_;
+  mcUSINT look_ahead_depth_ = 0;
+  mcBOOL look_ahead_pending_ = mcFALSE;
   ExecutionNode* fb_hold_ = nullptr;
   // Move Superimposed vars
   ExecutionNode* underlying_move_node_ = nullptr;
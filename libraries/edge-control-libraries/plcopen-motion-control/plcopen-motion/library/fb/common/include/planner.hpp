@@ -17,6 +17,7 @@
 #include <algo/private/include/poly_five_planner.hpp>
 #include <algo/private/include/line_planner.hpp>
 #include <chrono>
+#include <variant>
 
 using RTmotion::MC_ERROR_CODE;
 
@@ -57,16 +58,24 @@ public:
 
   void setFrequency(double f);
 
+  // Time scale of the next waypoints, only step based planners need it
+  void setTimeScale(double scale);
+
   RTmotion::PLANNER_TYPE getType() const;
 
 private:
+  // Only the planner selected by PLANNER_TYPE is alive, constructed in place
+  // on type switch, so an AxisPlanner costs its largest planner instead of
+  // the sum of all of them.
+  using PlannerStorage = std::variant<RuckigPlanner, ScurvePlannerOffLine,
+                                      PolyFivePlanner, LinePlanner>;
+
+  void selectPlanner(RTmotion::PLANNER_TYPE type);
+
+  PlannerStorage planner_;
   ScurvePlanner* scurve_planner_;
-  ScurvePlannerOnLine online_planner_;
-  ScurvePlannerOffLine offline_planner_;
-  RuckigPlanner ruckig_planner_;
-  PolyFivePlanner poly_five_planner_;
-  LinePlanner line_planner_;
   double start_time_;
+  double frequency_;
   RTmotion::PLANNER_TYPE type_;
 };
 
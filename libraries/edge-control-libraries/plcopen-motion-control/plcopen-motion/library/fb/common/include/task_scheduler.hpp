@@ -0,0 +1,115 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2025 Intel Corporation
+
+/**
+ * @file task_scheduler.hpp
+ *
+ * Maintainer: Yu Yan <yu.yan@intel.com>
+ *
+ */
+
+#pragma once
+
+#include <fb/common/include/global.hpp>
+
+#define TASK_MAX_NUM 8        // Task classes per scheduler
+#define TASK_MEMBER_MAX_NUM 64  // Function blocks/axes per task class
+
+namespace RTmotion
+{
+/**
+ * @brief IEC 61131-3 style cyclic task classes for function block execution.
+ *
+ * A task class runs its members every `divider` base cycles, e.g. divider 10
+ * on a 1 kHz motion loop gives a 100 Hz task for status reads feeding an HMI.
+ * Tasks run in priority order within a cycle (0 is the highest priority), so
+ * the fast motion task always runs first.
+ *
+ * Members of a slow task are spread over the cycles of its period: each one
+ * gets the phase where the fewest other members already run, which flattens
+ * the per-cycle load instead of stacking all slow work on cycle 0. Set
+ * `spread` to mcFALSE to run all members of a task in the same cycle.
+ *
+ * Registration is meant for initialization; runCycle() does not allocate.
+ */
+class TaskScheduler
+{
+public:
+  TaskScheduler();
+
+  /**
+   * @brief Add a task class.
+   * @param divider Run every `divider` calls of runCycle(), 1 for every cycle
+   * @param priority 0 is the highest priority
+   * @param spread Spread members over the cycles of the period
+   * @return Task index, -1 if the divider is 0 or the task table is full
+   */
+  mcDINT addTask(mcUDINT divider, mcUSINT priority, mcBOOL spread = mcTRUE);
+
+  /**
+   * @brief Register a function block, an axis or anything else providing
+   * runCycle() to a task.
+   * @return mcFALSE if the task does not exist or is full
+   */
+  template <typename T>
+  mcBOOL addMember(mcDINT task, T* member)
+  {
+    return addMember(task, member,
+                     [](void* obj) { static_cast<T*>(obj)->runCycle(); });
+  }
+
+  /**
+   * @brief Run the members due in this cycle, highest priority task first.
+   */
+  void runCycle();
+
+  /**
+   * @brief Restart the schedule at cycle 0, registered members are kept.
+   */
+  void reset();
+
+  mcULINT getCycleCount() const;
+  mcUDINT getTaskNum() const;
+  mcUDINT getMemberNum(mcDINT task) const;
+  mcUDINT getPhase(mcDINT task, mcUDINT member) const;
+
+  /**
+   * @brief Largest number of members run in one cycle over the common
+   * period of all tasks, limited to `horizon` cycles.
+   */
+  mcUDINT getPeakLoad(mcUDINT horizon = 10000) const;
+
+private:
+  typedef void (*RunFunc)(void*);
+
+  struct Member
+  {
+    void* obj_;
+    RunFunc run_;
+    mcUDINT phase_;
+  };
+
+  struct Task
+  {
+    mcUDINT divider_;
+    mcUSINT priority_;
+    mcBOOL spread_;
+    mcUDINT member_num_;
+    mcUDINT cursor_;  // First member due at or after the current slot
+    Member members_[TASK_MEMBER_MAX_NUM];  // Sorted by phase
+  };
+
+  mcBOOL addMember(mcDINT task, void* obj, RunFunc run);
+
+  /**
+   * @brief Phase of task period where a new member meets the least load.
+   */
+  mcUDINT choosePhase(const Task& task) const;
+
+  Task tasks_[TASK_MAX_NUM];
+  mcUDINT order_[TASK_MAX_NUM];  // Task indices by priority
+  mcUDINT task_num_;
+  mcULINT cycle_;
+};
+
+}  // namespace RTmotion
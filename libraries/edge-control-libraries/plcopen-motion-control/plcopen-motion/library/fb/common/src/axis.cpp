@@ -70,6 +70,7 @@ Axis::Axis()
   axis_override_factors_.override_flag = mcFALSE;
   superimposed_node_ptr_         = node_buffer_ + NODE_BUFFER_MAX_SIZE - 1;
   superimposed_node_ptr_->taken_ = mcTRUE;
+  bindNodePlanners();
 #ifdef ADDR_CHECK
   printf("Axis::axis_id_: %p\n", (void*)&axis_id_);
   printf("Axis::axis_pos_: %p\n", (void*)&axis_pos_);
@@ -94,11 +95,17 @@ Axis::Axis()
   for (size_t i = 0; i < node_num_; i++)
     printf("Axis::node: %p\n", (void*)&node_buffer_[i]);
   printf("Axis::it_: %p\n", (void*)&it_);
+  for (size_t i = 0; i < PLANNER_POOL_SIZE; i++)
+    printf("Axis::planner: %p\n", (void*)&planner_pool_[i]);
+  printf("Axis::footprint: %u bytes\n", getFootprint().axis_);
 #endif
 }
 
 Axis::Axis(const Axis& axis)
 {
+  superimposed_node_ptr_         = node_buffer_ + NODE_BUFFER_MAX_SIZE - 1;
+  superimposed_node_ptr_->taken_ = mcTRUE;
+  bindNodePlanners();
   *this = axis;
 }
 
@@ -164,6 +171,60 @@ Axis::~Axis()
   config_ = nullptr;
 }
 
+void Axis::setSnapshotTable(AxisSnapshotTable* table, mcUDINT index)
+{
+  snapshot_table_ = table;
+  snapshot_index_ = index;
+}
+
+void Axis::publishSnapshot()
+{
+  if (!snapshot_table_)
+    return;
+
+  AxisSnapshot snapshot = {};
+  snapshot.cycle_   = count_;
+  snapshot.stamp_   = stamp_;
+  snapshot.pos_     = toUserPos();
+  snapshot.vel_     = toUserVel();
+  snapshot.acc_     = toUserAcc();
+  snapshot.torque_  = toUserTorque();
+  snapshot.pos_cmd_ = toUserPosCmd();
+  snapshot.vel_cmd_ = toUserVelCmd();
+  snapshot.acc_cmd_ = toUserAccCmd();
+  snapshot.state_   = axis_state_;
+  snapshot.error_   = axis_error_;
+
+  ExecutionNode* node = motion_kernel_.getCommandingNode();
+  snapshot.motion_    = node ? node->getMotionMode() : mcNoMoveType;
+  snapshot.queued_    = motion_kernel_.getQueuedMotions().size();
+  snapshot.axis_id_ = axis_id_;
+  snapshot.power_   = power_status_;
+  snapshot.homed_   = axis_home_state_;
+  snapshot.warning_ = axis_has_warning_;
+
+  snapshot_table_->publish(snapshot_index_, snapshot);
+}
+
+void Axis::bindNodePlanners()
+{
+  for (size_t i = 0; i < NODE_BUFFER_MAX_SIZE; i++)
+    node_buffer_[i].setPlanner(&planner_pool_[0]);
+  superimposed_node_ptr_->setPlanner(&planner_pool_[1]);
+}
+
+AxisFootprint Axis::getFootprint()
+{
+  AxisFootprint footprint;
+  footprint.axis_     = sizeof(Axis);
+  footprint.node_     = sizeof(ExecutionNode);
+  footprint.nodes_    = sizeof(ExecutionNode) * NODE_BUFFER_MAX_SIZE;
+  footprint.planner_  = sizeof(trajectory_processing::AxisPlanner);
+  footprint.planners_ = sizeof(trajectory_processing::AxisPlanner) *
+                        PLANNER_POOL_SIZE;
+  return footprint;
+}
+
 void Axis::deleteServo()
 {
   if (servo_ != nullptr)
@@ -215,9 +276,20 @@ void Axis::setAxisConfig(AxisConfig* config)
   if (config_->frequency_ != 0)
   {
     delta_time_ = 1 / config_->frequency_;
-    for (size_t i = 0; i < node_num_; i++)
+    for (size_t i = 0; i < PLANNER_POOL_SIZE; i++)
+      planner_pool_[i].setFrequency(config_->frequency_);
+    for (size_t i = 0; i < NODE_BUFFER_MAX_SIZE; i++)
       node_buffer_[i].setFrequency(config_->frequency_);
   }
+
+  // Configure the whole pool, the queue can be resized later and the last
+  // node is the superimposed one
+  for (size_t i = 0; i < NODE_BUFFER_MAX_SIZE; i++)
+    node_buffer_[i].setTimeScaling(config_->override_time_scaling_,
+                                   config_->override_scale_rate_,
+                                   config_->override_scale_acc_);
+
+  motion_kernel_.setLookAheadDepth(config_->look_ahead_depth_);
 }
 
 void Axis::setNodeQueueSize(mcUSINT size)
@@ -272,6 +344,8 @@ void Axis::runCycle()
     add_fb_    = mcFALSE;
     add_count_ = 0;
   }
+
+  publishSnapshot();
 }
 
 void Axis::runCycle(double pos, double vel)
@@ -310,6 +384,8 @@ void Axis::runCycle(double pos, double vel)
     add_fb_    = mcFALSE;
     add_count_ = 0;
   }
+
+  publishSnapshot();
 }
 
 mcLREAL Axis::getPos()
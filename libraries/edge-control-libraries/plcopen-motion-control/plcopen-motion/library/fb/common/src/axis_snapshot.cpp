@@ -0,0 +1,80 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2025 Intel Corporation
+
+/**
+ * @file axis_snapshot.cpp
+ *
+ * Maintainer: Yu Yan <yu.yan@intel.com>
+ *
+ */
+
+#include <fb/common/include/axis_snapshot.hpp>
+#include <cstring>
+
+namespace RTmotion
+{
+AxisSnapshotTable::AxisSnapshotTable()
+{
+  for (size_t i = 0; i < AXIS_SNAPSHOT_MAX_NUM; i++)
+  {
+    slots_[i].sequence_.store(0, std::memory_order_relaxed);
+    for (size_t j = 0; j < WORD_NUM; j++)
+      slots_[i].data_[j].store(0, std::memory_order_relaxed);
+  }
+}
+
+void AxisSnapshotTable::publish(mcUDINT index, const AxisSnapshot& snapshot)
+{
+  if (index >= AXIS_SNAPSHOT_MAX_NUM)
+    return;
+
+  mcULINT words[WORD_NUM] = {};
+  memcpy(words, &snapshot, sizeof(AxisSnapshot));
+
+  // Single writer per slot, mark it odd before touching the data
+  Slot& slot        = slots_[index];
+  const mcULINT seq = slot.sequence_.load(std::memory_order_relaxed);
+  slot.sequence_.store(seq + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  for (size_t i = 0; i < WORD_NUM; i++)
+    slot.data_[i].store(words[i], std::memory_order_relaxed);
+  slot.sequence_.store(seq + 2, std::memory_order_release);
+}
+
+mcBOOL AxisSnapshotTable::read(mcUDINT index, AxisSnapshot& snapshot,
+                               mcUDINT retry) const
+{
+  if (index >= AXIS_SNAPSHOT_MAX_NUM)
+    return mcFALSE;
+
+  const Slot& slot = slots_[index];
+  mcULINT words[WORD_NUM];
+  for (mcUDINT i = 0; i < retry; i++)
+  {
+    const mcULINT seq = slot.sequence_.load(std::memory_order_acquire);
+    if (seq == 0)
+      return mcFALSE;  // Never published
+    if (seq & 1)
+      continue;  // Being written
+
+    for (size_t j = 0; j < WORD_NUM; j++)
+      words[j] = slot.data_[j].load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    if (slot.sequence_.load(std::memory_order_relaxed) == seq)
+    {
+      memcpy(&snapshot, words, sizeof(AxisSnapshot));
+      return mcTRUE;
+    }
+  }
+  return mcFALSE;
+}
+
+mcULINT AxisSnapshotTable::getVersion(mcUDINT index) const
+{
+  if (index >= AXIS_SNAPSHOT_MAX_NUM)
+    return 0;
+  return slots_[index].sequence_.load(std::memory_order_acquire) / 2;
+}
+
+}  // namespace RTmotion
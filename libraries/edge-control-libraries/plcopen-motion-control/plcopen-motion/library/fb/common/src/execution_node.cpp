@@ -31,7 +31,14 @@ ExecutionNode::ExecutionNode()
   , node_freq_(1000)
   , node_delta_time_(0.001)
   , node_active_time_(0)
-  , planner_()
+  , time_scaling_(mcFALSE)
+  , time_scale_(1)
+  , time_scale_rate_(0)
+  , time_scale_target_(1)
+  , time_scale_rate_max_(1)
+  , time_scale_acc_max_(10)
+  , time_scale_acc_lim_(0)
+  , planner_(nullptr)
   , planner_type_(mcOffLine)
 {
   pos_cmd_ = 0;
@@ -60,7 +67,7 @@ ExecutionNode::ExecutionNode()
 
 #ifdef ADDR_CHECK
   printf("ExecutionNode::this: %p\n", (void*)this);
-  printf("ExecutionNode::planner_: %p\n", (void*)&planner_);
+  printf("ExecutionNode::planner_: %p\n", (void*)planner_);
 #endif
 }
 
@@ -122,6 +129,14 @@ void ExecutionNode::copyMemberVar(const ExecutionNode& node)
     node_delta_time_  = node.node_delta_time_;
     node_active_time_ = node.node_active_time_;
 
+    time_scaling_        = node.time_scaling_;
+    time_scale_          = node.time_scale_;
+    time_scale_rate_     = node.time_scale_rate_;
+    time_scale_target_   = node.time_scale_target_;
+    time_scale_rate_max_ = node.time_scale_rate_max_;
+    time_scale_acc_max_  = node.time_scale_acc_max_;
+    time_scale_acc_lim_  = node.time_scale_acc_lim_;
+
     planner_      = node.planner_;
     planner_type_ = node.planner_type_;
   }
@@ -170,11 +185,24 @@ void ExecutionNode::setAdvancedParams(mcLREAL duration, mcLREAL start_pos,
 
 void ExecutionNode::setFrequency(mcLREAL f)
 {
-  planner_.setFrequency(f);
+  if (planner_)
+    planner_->setFrequency(f);
   node_freq_       = f;
   node_delta_time_ = 1 / f;
 }
 
+void ExecutionNode::setPlanner(trajectory_processing::AxisPlanner* planner)
+{
+  planner_ = planner;
+}
+
+void ExecutionNode::setTimeScaling(mcBOOL enable, mcLREAL rate, mcLREAL acc)
+{
+  time_scaling_        = enable;
+  time_scale_rate_max_ = rate;
+  time_scale_acc_max_  = acc;
+}
+
 void ExecutionNode::reset()
 {
   done_            = mcFALSE;
@@ -349,6 +377,16 @@ MC_MOTION_MODE ExecutionNode::getMotionMode()
   return motion_mode_;
 }
 
+mcLREAL ExecutionNode::getStartPos()
+{
+  return start_pos_;
+}
+
+mcLREAL ExecutionNode::getStartVel()
+{
+  return start_vel_;
+}
+
 mcLREAL ExecutionNode::getEndPos()
 {
   return end_pos_;
@@ -369,6 +407,21 @@ mcLREAL ExecutionNode::getVelocity()
   return velocity_;
 }
 
+mcLREAL ExecutionNode::getAcceleration()
+{
+  return acceleration_;
+}
+
+mcLREAL ExecutionNode::getDeceleration()
+{
+  return deceleration_;
+}
+
+mcLREAL ExecutionNode::getJerk()
+{
+  return jerk_;
+}
+
 void ExecutionNode::getCommands(mcLREAL* pos_cmd, mcLREAL* vel_cmd,
                                 mcLREAL* acc_cmd)
 {
@@ -441,8 +494,11 @@ mcBOOL ExecutionNode::isError()
 void ExecutionNode::onActive(MC_AXIS_STATES* current_state)
 {
   setPlannerStartTime(0);
-  node_active_time_ = 0;
-  MC_ERROR_CODE res = mcErrorCodeGood;
+  node_active_time_  = 0;
+  time_scale_        = 1;
+  time_scale_rate_   = 0;
+  time_scale_target_ = 1;
+  MC_ERROR_CODE res  = mcErrorCodeGood;
   switch (motion_mode_)
   {
     case mcHaltMode:
@@ -492,12 +548,19 @@ void ExecutionNode::onActive(MC_AXIS_STATES* current_state)
 
 void ExecutionNode::onExecution(mcLREAL master_ref_pos, mcLREAL master_ref_vel)
 {
-  node_active_time_ += node_delta_time_;
+  stepTimeScale();
+  node_active_time_ += node_delta_time_ * time_scale_;
+  if (!planner_)  // node is not attached to an axis
+  {
+    onError(mcErrorCodeSetAxisError);
+    return;
+  }
+
   // Replan trajectory
   if (need_plan_ == mcTRUE)
   {
     need_plan_ = mcFALSE;
-    planner_.setCondition(
+    planner_->setCondition(
         start_pos_, end_pos_, start_vel_, end_vel_ * override_factors_.vel,
         start_acc_, end_acc_, duration_, velocity_ * override_factors_.vel,
         acceleration_ * override_factors_.acc, jerk_ * override_factors_.jerk,
@@ -509,23 +572,33 @@ void ExecutionNode::onExecution(mcLREAL master_ref_pos, mcLREAL master_ref_vel)
         start_pos_, end_pos_, start_vel_, end_vel_ * override_factors_.vel,
         velocity_ * override_factors_.vel,
         acceleration_ * override_factors_.acc, jerk_ * override_factors_.jerk);
-    MC_ERROR_CODE res = planner_.onReplan();
+    MC_ERROR_CODE res = planner_->onReplan();
     if (res)
       onError(res);
   }
 
   // Compute waypoint
-  if (planner_.getType() == mcPoly5 || planner_.getType() == mcLine)
+  if (planner_->getType() == mcPoly5 || planner_->getType() == mcLine)
     error_id_ =
-        planner_.onExecution(master_ref_pos, &pos_tmp_, &vel_tmp_, &acc_tmp_);
+        planner_->onExecution(master_ref_pos, &pos_tmp_, &vel_tmp_, &acc_tmp_);
   else
-    error_id_ = planner_.onExecution(node_active_time_, &pos_tmp_, &vel_tmp_,
+  {
+    planner_->setTimeScale(time_scale_);
+    error_id_ = planner_->onExecution(node_active_time_, &pos_tmp_, &vel_tmp_,
                                      &acc_tmp_);
+    // Derivatives of the profile evaluated at the scaled time
+    if (time_scale_ != 1 || time_scale_rate_ != 0)
+    {
+      acc_tmp_ =
+          acc_tmp_ * time_scale_ * time_scale_ + vel_tmp_ * time_scale_rate_;
+      vel_tmp_ = vel_tmp_ * time_scale_;
+    }
+  }
 
   DEBUG_PRINT("ExecutionNode::onExecution: pos: %f, vel: %f, acc: %f\n",
               pos_tmp_, vel_tmp_, acc_tmp_);
 
-  if ((planner_.getType() == mcPoly5 || planner_.getType() == mcLine) &&
+  if ((planner_->getType() == mcPoly5 || planner_->getType() == mcLine) &&
       (abs(vel_tmp_ * master_ref_vel) > velocity_ * 1.01 ||
        abs(acc_tmp_ * master_ref_vel * master_ref_vel) > acceleration_ * 1.01))
   {
@@ -603,20 +676,22 @@ mcBOOL ExecutionNode::checkMissionDone(const mcLREAL axis_pos,
                                        const mcLREAL axis_vel)
 {
   mcBOOL res = mcFALSE;
+  // End velocity of the profile as planned, then time scaled
+  const mcLREAL end_vel =
+      end_vel_ * override_factors_.vel * time_scale_target_;
   switch (motion_mode_)
   {
     case mcMoveAbsoluteMode:
     case mcMoveAdditiveMode:
     case mcMoveRelativeMode: {
       if (fabs(axis_pos - end_pos_) <= pos_done_factor_ &&
-          fabs(axis_vel - end_vel_ * override_factors_.vel) <= vel_done_factor_)
+          fabs(axis_vel - end_vel) <= vel_done_factor_)
         res = mcTRUE;
       DEBUG_PRINT("ExecutionNode::checkMissionDone: \n"
                   "\tfabs(axis_pos - end_pos_): %f, pos_done_factor_: %f, \n"
                   "\tfabs(axis_vel - end_vel_): %f, vel_done_factor_: %f\n",
                   fabs(axis_pos - end_pos_), pos_done_factor_,
-                  fabs(axis_vel - end_vel_ * override_factors_.vel),
-                  vel_done_factor_);
+                  fabs(axis_vel - end_vel), vel_done_factor_);
     }
     break;
     case mcHaltMode:
@@ -624,30 +699,27 @@ mcBOOL ExecutionNode::checkMissionDone(const mcLREAL axis_pos,
     case mcGearInMode:
     case mcSyncOutMode:
     case mcMoveVelocityMode: {
-      if (fabs(axis_vel - end_vel_ * override_factors_.vel) <= vel_done_factor_)
+      if (fabs(axis_vel - end_vel) <= vel_done_factor_)
         res = mcTRUE;
     }
     break;
     case mcHomingMode: {
       if (isnan(position_))
       {
-        if (fabs(axis_vel - end_vel_ * override_factors_.vel) <=
-            vel_done_factor_)
+        if (fabs(axis_vel - end_vel) <= vel_done_factor_)
           res = mcTRUE;
       }
       else
       {
         if (fabs(axis_pos - end_pos_) <= pos_done_factor_ &&
-            fabs(axis_vel - end_vel_ * override_factors_.vel) <=
-                vel_done_factor_)
+            fabs(axis_vel - end_vel) <= vel_done_factor_)
           res = mcTRUE;
         DEBUG_PRINT("ExecutionNode::checkMissionDone: \n"
                     "\tfabs(axis_pos - end_pos_): %f, fabs(start_pos_ -  "
                     "end_pos_) * 0.015: %f, \n"
                     "\tfabs(axis_vel - end_vel_): %f, __EPSILON: %f\n",
                     fabs(axis_pos - end_pos_), pos_done_factor_,
-                    fabs(axis_vel - end_vel_ * override_factors_.vel),
-                    vel_done_factor_);
+                    fabs(axis_vel - end_vel), vel_done_factor_);
       }
     }
     break;
@@ -681,9 +753,92 @@ void ExecutionNode::updateOverrideFactors(OverrideFactors& override_factors)
   }
 }
 
+mcBOOL ExecutionNode::scaleOverrideFactors(
+    const OverrideFactors& override_factors)
+{
+  if (time_scaling_ == mcFALSE || active_ == mcFALSE || need_plan_ == mcTRUE ||
+      planner_type_ == mcPoly5 || planner_type_ == mcLine ||
+      override_factors_.vel <= 0 || override_factors.vel < 0)
+    return mcFALSE;
+
+  switch (motion_mode_)
+  {
+    case mcMoveAbsoluteMode:
+    case mcMoveAdditiveMode:
+    case mcMoveRelativeMode:
+    case mcMoveVelocityMode:
+    case mcHaltMode:
+      break;
+    default:
+      return mcFALSE;
+  }
+
+  // The profile was planned with override_factors_. Running it with time
+  // scale s scales velocity by s, acceleration by s^2 and jerk by s^3.
+  const mcLREAL scale     = override_factors.vel / override_factors_.vel;
+  const mcLREAL tolerance = 1 + 1e-6;
+  if (override_factors_.acc * scale * scale >
+          override_factors.acc * tolerance ||
+      override_factors_.jerk * scale * scale * scale >
+          override_factors.jerk * tolerance)
+    return mcFALSE;
+
+  time_scale_target_  = scale;
+  time_scale_acc_lim_ = acceleration_ * override_factors.acc * tolerance;
+  DEBUG_PRINT("ExecutionNode::scaleOverrideFactors: time scale target %f\n",
+              time_scale_target_);
+  return mcTRUE;
+}
+
+mcLREAL ExecutionNode::getTimeScale()
+{
+  return time_scale_;
+}
+
+void ExecutionNode::stepTimeScale()
+{
+  const mcLREAL error = time_scale_target_ - time_scale_;
+  if (error == 0 && time_scale_rate_ == 0)
+    return;
+
+  // Fastest rate that can still settle on the target when braking by one
+  // rate change step per cycle, limited to the max rate
+  const mcLREAL step = time_scale_acc_max_ * node_delta_time_;
+  mcLREAL rate =
+      step * (sqrt(2 * fabs(error) / (step * node_delta_time_) + 0.25) - 0.5);
+  rate = copysign(fmin(rate, time_scale_rate_max_), error);
+  rate = time_scale_rate_ + fmax(-step, fmin(step, rate - time_scale_rate_));
+
+  // The commanded acceleration is a * s^2 + v * rate for the profile velocity
+  // v and acceleration a of the last cycle, keep the v * rate term within the
+  // acceleration headroom left
+  if (time_scale_ > 0 && vel_tmp_ != 0)
+  {
+    const mcLREAL vel    = vel_tmp_ / time_scale_;
+    const mcLREAL acc    = acc_tmp_ - vel * time_scale_rate_;
+    const mcLREAL rate_1 = (-time_scale_acc_lim_ - acc) / vel;
+    const mcLREAL rate_2 = (time_scale_acc_lim_ - acc) / vel;
+    rate = fmax(fmin(fmin(rate_1, rate_2), 0),
+                fmin(fmax(fmax(rate_1, rate_2), 0), rate));
+  }
+  time_scale_rate_ = rate;
+  time_scale_ += time_scale_rate_ * node_delta_time_;
+
+  // Settle once the target is passed or within the last step
+  const mcLREAL remain = time_scale_target_ - time_scale_;
+  if (remain * error <= 0 ||
+      (fabs(remain) <= fabs(time_scale_rate_) * node_delta_time_ &&
+       fabs(time_scale_rate_) <= step))
+  {
+    time_scale_      = time_scale_target_;
+    time_scale_rate_ = 0;
+  }
+}
+
 void ExecutionNode::setPlannerStartTime(mcLREAL t)
 {
-  planner_.setStartTime(t);
+  if (planner_)
+    planner_->setStartTime(t);
 }
 
 MC_ERROR_CODE ExecutionNode::changeAxisStates(MC_AXIS_STATES* current_state,
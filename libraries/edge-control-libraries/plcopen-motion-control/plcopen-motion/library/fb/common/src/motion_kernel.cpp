@@ -28,6 +28,9 @@ void MotionKernel::runCycle(const mcLREAL master_ref_pos,
                             const mcLREAL axis_ref_acc, MC_AXIS_STATES* state,
                             OverrideFactors& override_factors)
 {
+  // Moves added in the last cycle are planned together here
+  updateLookAhead();
+
   // FB queue process
   if (!fb_queue_.empty())
   {
@@ -96,14 +99,18 @@ void MotionKernel::runCycle(const mcLREAL master_ref_pos,
           }
         }
         fb_front->onExecution(master_ref_pos, master_ref_vel);
-        // check override state and replan the fb_front if it is overridden
+        // check override state and replan the fb_front if it is overridden,
+        // unless its profile can be time scaled to the new factors
         if (override_factors.override_flag == mcTRUE)
         {
-          fb_front->setReplan();
-          fb_front->restart();
-          fb_front->updateOverrideFactors(override_factors);
-          setNodeStartState(fb_front, axis_ref_pos, axis_ref_vel, axis_ref_acc,
-                            fb_front->getEndAcc());
+          if (fb_front->scaleOverrideFactors(override_factors) == mcFALSE)
+          {
+            fb_front->setReplan();
+            fb_front->restart();
+            fb_front->updateOverrideFactors(override_factors);
+            setNodeStartState(fb_front, axis_ref_pos, axis_ref_vel,
+                              axis_ref_acc, fb_front->getEndAcc());
+          }
           override_factors.override_flag = mcFALSE;
         }
         underlying_move_node_ = fb_front;
@@ -223,26 +230,16 @@ void MotionKernel::addFBToQueue(ExecutionNode* node, mcLREAL current_pos,
         }
         setAllFBsAborted();
         break;
-      case mcBlendingPrevious: {
-        fb_prev->setEndVel(fb_prev->getVelocity());
-        fb_prev->setReplan();
-      }
-      break;
-      case mcBlendingNext: {
-        fb_prev->setEndVel(node->getVelocity());
-        fb_prev->setReplan();
-      }
-      break;
-      case mcBlendingHigh: {
-        fb_prev->setEndVel(
-            std::max(fb_prev->getVelocity(), node->getVelocity()));
-        fb_prev->setReplan();
-      }
-      break;
+      case mcBlendingPrevious:
+      case mcBlendingNext:
+      case mcBlendingHigh:
       case mcBlendingLow: {
-        fb_prev->setEndVel(
-            std::min(fb_prev->getVelocity(), node->getVelocity()));
-        fb_prev->setReplan();
+        // With look-ahead the junction velocities are planned below
+        if (look_ahead_depth_ == 0)
+        {
+          fb_prev->setEndVel(getBlendingVelocity(fb_prev, node));
+          fb_prev->setReplan();
+        }
       }
       break;
       default:
@@ -260,6 +257,10 @@ void MotionKernel::addFBToQueue(ExecutionNode* node, mcLREAL current_pos,
   }
 
   fb_queue_.push_back(node);
+
+  // Planned once in the next cycle, however many moves are added in this one
+  if (look_ahead_depth_ > 0 && node->getBufferMode() != mcAborting)
+    look_ahead_pending_ = mcTRUE;
 }
 
 std::deque<ExecutionNode*>& MotionKernel::getQueuedMotions()
@@ -267,6 +268,196 @@ std::deque<ExecutionNode*>& MotionKernel::getQueuedMotions()
   return fb_queue_;
 }
 
+ExecutionNode* MotionKernel::getCommandingNode()
+{
+  if (!fb_queue_.empty())
+    return fb_queue_.front();
+  return fb_hold_;
+}
+
+void MotionKernel::setLookAheadDepth(mcUSINT depth)
+{
+  if (depth > LOOK_AHEAD_MAX_DEPTH)
+  {
+    INFO_PRINT("MotionKernel::setLookAheadDepth Depth cannot be larger than "
+               "%d.\n",
+               LOOK_AHEAD_MAX_DEPTH);
+    depth = LOOK_AHEAD_MAX_DEPTH;
+  }
+  look_ahead_depth_ = depth;
+}
+
+mcUSINT MotionKernel::getLookAheadDepth()
+{
+  return look_ahead_depth_;
+}
+
+void MotionKernel::updateLookAhead()
+{
+  if (look_ahead_pending_ == mcFALSE)
+    return;
+  look_ahead_pending_ = mcFALSE;
+  if (!fb_queue_.empty())
+    planLookAhead();
+}
+
+mcLREAL MotionKernel::getBlendingVelocity(ExecutionNode* prev,
+                                          ExecutionNode* next)
+{
+  switch (next->getBufferMode())
+  {
+    case mcBlendingPrevious:
+      return prev->getVelocity();
+    case mcBlendingNext:
+      return next->getVelocity();
+    case mcBlendingHigh:
+      return std::max(prev->getVelocity(), next->getVelocity());
+    case mcBlendingLow:
+      return std::min(prev->getVelocity(), next->getVelocity());
+    default:
+      return 0.0;  // Buffered moves start from standstill
+  }
+}
+
+static mcBOOL isLookAheadMove(ExecutionNode* node)
+{
+  switch (node->getMotionMode())
+  {
+    case mcMoveAbsoluteMode:
+    case mcMoveAdditiveMode:
+    case mcMoveRelativeMode:
+      if (node->getPlannerType() == mcPoly5 || node->getPlannerType() == mcLine)
+        return mcFALSE;
+      return mcTRUE;
+    default:
+      return mcFALSE;
+  }
+}
+
+// Highest speed reachable from v0 within dist by a jerk limited profile that
+// starts and ends without acceleration. Uses the same bound as
+// ScurvePlannerOffLine::scurveCheckPosibility, which is symmetric, so it also
+// gives the highest speed that can still slow down to v0 within dist.
+static mcLREAL getReachableVelocity(mcLREAL v0, mcLREAL dist, mcLREAL acc,
+                                    mcLREAL jerk)
+{
+  if (acc <= 0 || dist <= 0)
+    return v0;
+
+  // Constant acceleration is the upper bound, jerk only lowers it
+  mcLREAL lo = v0;
+  mcLREAL hi = sqrt(v0 * v0 + 2 * acc * dist);
+  if (jerk <= 0)
+    return hi;
+
+  for (mcUSINT i = 0; i < 32; i++)
+  {
+    const mcLREAL v  = 0.5 * (lo + hi);
+    const mcLREAL dv = v - v0;
+    const mcLREAL t =
+        dv >= acc * acc / jerk ? dv / acc + acc / jerk : 2 * sqrt(dv / jerk);
+    if (0.5 * (v0 + v) * t < dist)
+      lo = v;
+    else
+      hi = v;
+  }
+  return lo;
+}
+
+void MotionKernel::planLookAhead()
+{
+  // Collect the newest moves that blend into each other, up to the depth
+  const size_t last = fb_queue_.size() - 1;
+  if (isLookAheadMove(fb_queue_[last]) == mcFALSE)
+    return;
+
+  size_t first = last;
+  while (first > 0 && last - first + 1 < look_ahead_depth_ &&
+         fb_queue_[first]->getBufferMode() != mcAborting &&
+         isLookAheadMove(fb_queue_[first - 1]) == mcTRUE)
+    first--;
+
+  const size_t num = last - first + 1;
+  if (num < 2)
+    return;
+
+  mcLREAL dist[LOOK_AHEAD_MAX_DEPTH];
+  mcLREAL dir[LOOK_AHEAD_MAX_DEPTH];
+  mcLREAL vel[LOOK_AHEAD_MAX_DEPTH];  // Speed at the end of each move
+  for (size_t i = 0; i < num; i++)
+  {
+    ExecutionNode* node = fb_queue_[first + i];
+    const mcLREAL d     = node->getEndPos() - node->getStartPos();
+    dist[i]             = fabs(d);
+    dir[i]              = d < 0 ? -1.0 : 1.0;
+  }
+
+  // The active front move only has the rest of its distance left, and speeds
+  // up from its current velocity
+  mcLREAL start_vel =
+      std::max(0.0, dir[0] * fb_queue_[first]->getStartVel());
+  if (first == 0 && fb_queue_[0]->isActive() == mcTRUE)
+  {
+    mcLREAL pos_cmd, vel_cmd, acc_cmd;
+    fb_queue_[0]->getCommands(&pos_cmd, &vel_cmd, &acc_cmd);
+    dist[0] =
+        std::max(0.0, dir[0] * (fb_queue_[0]->getEndPos() - pos_cmd));
+    start_vel = std::max(0.0, dir[0] * vel_cmd);
+  }
+
+  // Junction speeds requested by the buffer modes, moves that reverse
+  // direction meet at standstill
+  for (size_t i = 0; i + 1 < num; i++)
+  {
+    if (dir[i] == dir[i + 1] && dist[i] > 0 && dist[i + 1] > 0)
+      vel[i] = getBlendingVelocity(fb_queue_[first + i],
+                                   fb_queue_[first + i + 1]);
+    else
+      vel[i] = 0.0;
+  }
+  vel[num - 1] = std::max(0.0, dir[num - 1] * fb_queue_[last]->getEndVel());
+
+  // Backward pass, every move can slow down to its end speed. It brakes with
+  // its deceleration, bounded by the acceleration its profile is planned with
+  for (size_t i = num - 1; i > 0; i--)
+  {
+    ExecutionNode* node = fb_queue_[first + i];
+    mcLREAL dec         = node->getAcceleration();
+    if (node->getDeceleration() > 0)
+      dec = std::min(dec, node->getDeceleration());
+    vel[i - 1] = std::min(
+        vel[i - 1],
+        getReachableVelocity(vel[i], dist[i], dec, node->getJerk()));
+  }
+
+  // Forward pass, every move can speed up to its end speed
+  for (size_t i = 0; i + 1 < num; i++)
+  {
+    ExecutionNode* node = fb_queue_[first + i];
+    vel[i]              = std::min(vel[i],
+                                   getReachableVelocity(start_vel, dist[i],
+                                                        node->getAcceleration(),
+                                                        node->getJerk()));
+    start_vel = vel[i];
+  }
+
+  // Only moves whose boundary changed are planned again, queued moves plan
+  // once when they become active
+  for (size_t i = 0; i + 1 < num; i++)
+  {
+    ExecutionNode* prev = fb_queue_[first + i];
+    ExecutionNode* next = fb_queue_[first + i + 1];
+    const mcLREAL v     = dir[i] * vel[i];
+    if (prev->getEndVel() != v)
+    {
+      prev->setEndVel(v);
+      prev->setReplan();
+    }
+    next->setStartVel(v);
+  }
+  DEBUG_PRINT("MotionKernel::planLookAhead: planned %zu moves\n", num);
+}
+
 void MotionKernel::setAllFBsAborted()
 {
   while (!fb_queue_.empty())
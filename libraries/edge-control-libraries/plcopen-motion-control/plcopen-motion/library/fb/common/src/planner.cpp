@@ -14,19 +14,15 @@
 
 namespace trajectory_processing
 {
-AxisPlanner::AxisPlanner()
-  : online_planner_()
-  , offline_planner_()
-  , ruckig_planner_()
-  , poly_five_planner_()
-  , line_planner_()
+AxisPlanner::AxisPlanner() : planner_(std::in_place_type<RuckigPlanner>)
 {
   start_time_     = 0.0;
+  frequency_      = 0.0;
   type_           = RTmotion::mcRuckig;
-  scurve_planner_ = &ruckig_planner_;
+  scurve_planner_ = &std::get<RuckigPlanner>(planner_);
 }
 
-AxisPlanner::AxisPlanner(const AxisPlanner& planner)
+AxisPlanner::AxisPlanner(const AxisPlanner& planner) : AxisPlanner()
 {
   *this = planner;
 }
@@ -35,7 +31,8 @@ AxisPlanner& AxisPlanner::operator=(const AxisPlanner& planner)
 {
   if (this != &planner)
   {
-    type_       = planner.type_;
+    if (planner.frequency_ > 0)
+      setFrequency(planner.frequency_);
     start_time_ = planner.start_time_;
     this->setCondition(planner.getScurveCondition(), planner.getType());
   }
@@ -47,6 +44,37 @@ AxisPlanner::~AxisPlanner()
   scurve_planner_ = nullptr;
 }
 
+void AxisPlanner::selectPlanner(RTmotion::PLANNER_TYPE type)
+{
+  if (type == type_)
+    return;
+
+  switch (type)
+  {
+    case RTmotion::mcOffLine:
+      scurve_planner_ = &planner_.emplace<ScurvePlannerOffLine>();
+      break;
+    case RTmotion::mcRuckig:
+      scurve_planner_ = &planner_.emplace<RuckigPlanner>();
+      break;
+    case RTmotion::mcPoly5:
+      scurve_planner_ = &planner_.emplace<PolyFivePlanner>();
+      break;
+    case RTmotion::mcLine:
+      scurve_planner_ = &planner_.emplace<LinePlanner>();
+      break;
+    case RTmotion::mcOnLine:
+    default:
+      // Not selectable, keep the current planner
+      return;
+  }
+  type_ = type;
+
+  // A freshly constructed planner starts at its default rate
+  if (frequency_ > 0)
+    scurve_planner_->setFrequency(frequency_);
+}
+
 void AxisPlanner::setCondition(const ScurveCondition& condition,
                                const RTmotion::PLANNER_TYPE type)
 {
@@ -61,34 +89,11 @@ void AxisPlanner::setCondition(double start_pos, double end_pos,
                                double duration, double vel_max, double acc_max,
                                double jerk_max, RTmotion::PLANNER_TYPE type)
 {
-  switch (type)
-  {
-    case RTmotion::mcOffLine: {
-      type_           = RTmotion::mcOffLine;
-      scurve_planner_ = &offline_planner_;
-      break;
-    }
-    case RTmotion::mcRuckig: {
-      type_           = RTmotion::mcRuckig;
-      scurve_planner_ = &ruckig_planner_;
-      break;
-    }
-    case RTmotion::mcPoly5: {
-      type_                                             = RTmotion::mcPoly5;
-      scurve_planner_                                   = &poly_five_planner_;
-      ((PolyFivePlanner*)scurve_planner_)->condition_.T = duration;
-      break;
-    }
-    case RTmotion::mcLine: {
-      type_                                         = RTmotion::mcLine;
-      scurve_planner_                               = &line_planner_;
-      ((LinePlanner*)scurve_planner_)->condition_.T = duration;
-      break;
-    }
-    case RTmotion::mcOnLine:
-    default:
-      break;
-  }
+  selectPlanner(type);
+  if (type_ == RTmotion::mcPoly5)
+    ((PolyFivePlanner*)scurve_planner_)->condition_.T = duration;
+  else if (type_ == RTmotion::mcLine)
+    ((LinePlanner*)scurve_planner_)->condition_.T = duration;
 
   scurve_planner_->condition_.q0    = start_pos;
   scurve_planner_->condition_.q1    = end_pos;
@@ -104,16 +109,10 @@ void AxisPlanner::setCondition(double start_pos, double end_pos,
               scurve_planner_->condition_.q0, scurve_planner_->condition_.q1,
               scurve_planner_->condition_.v0, scurve_planner_->condition_.v1);
 
-  // printf("setCondition: online_planner_: %p, offline_planner_: %p\n",
-  // (void*)&online_planner_, (void*)&offline_planner_); printf("setCondition:
-  // scurve_planner_: %p, ruckig_planner_: %p\n", (void*)scurve_planner_,
-  // (void*)&ruckig_planner_);
 }
 
 MC_ERROR_CODE AxisPlanner::planTrajectory()
 {
-  // printf("planTrajectory: scurve_planner_: %p, ruckig_planner_: %p\n",
-  // (void*)scurve_planner_, (void*)&ruckig_planner_);
   return scurve_planner_->plan();
 }
 
@@ -195,9 +194,16 @@ void AxisPlanner::setStartTime(double t)
 
 void AxisPlanner::setFrequency(double f)
 {
+  frequency_ = f;
   scurve_planner_->setFrequency(f);
 }
 
+void AxisPlanner::setTimeScale(double scale)
+{
+  if (type_ == RTmotion::mcRuckig)
+    std::get<RuckigPlanner>(planner_).setTimeScale(scale);
+}
+
 RTmotion::PLANNER_TYPE AxisPlanner::getType() const
 {
   return type_;
@@ -0,0 +1,206 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2025 Intel Corporation
+
+/**
+ * @file task_scheduler.cpp
+ *
+ * Maintainer: Yu Yan <yu.yan@intel.com>
+ *
+ */
+
+#include <fb/common/include/task_scheduler.hpp>
+#include <fb/common/include/logging.hpp>
+#include <algorithm>
+#include <numeric>
+#include <stdio.h>
+
+namespace RTmotion
+{
+TaskScheduler::TaskScheduler() : task_num_(0), cycle_(0)
+{
+}
+
+mcDINT TaskScheduler::addTask(mcUDINT divider, mcUSINT priority,
+                              mcBOOL spread)
+{
+  if (divider == 0)
+  {
+    INFO_PRINT("TaskScheduler::addTask: divider cannot be 0.\n");
+    return -1;
+  }
+  if (task_num_ >= TASK_MAX_NUM)
+  {
+    INFO_PRINT("TaskScheduler::addTask: cannot add more than %d tasks.\n",
+               TASK_MAX_NUM);
+    return -1;
+  }
+
+  Task& task       = tasks_[task_num_];
+  task.divider_    = divider;
+  task.priority_   = priority;
+  task.spread_     = spread;
+  task.member_num_ = 0;
+  task.cursor_     = 0;
+
+  // Keep the run order sorted by priority, equal priorities in added order
+  mcUDINT pos = task_num_;
+  while (pos > 0 && tasks_[order_[pos - 1]].priority_ > priority)
+  {
+    order_[pos] = order_[pos - 1];
+    pos--;
+  }
+  order_[pos] = task_num_;
+
+  return task_num_++;
+}
+
+mcUDINT TaskScheduler::choosePhase(const Task& task) const
+{
+  if (task.divider_ == 1)
+    return 0;
+  if (task.spread_ == mcFALSE && task.member_num_ > 0)
+    return task.members_[0].phase_;
+
+  // A member with period D and phase p meets a member with period E and
+  // phase q in gcd(D, E) / E of its cycles when p == q (mod gcd(D, E)), and
+  // never otherwise. Pick the phase with the lowest summed share.
+  mcUDINT best_phase = 0;
+  double best_load   = -1;
+  for (mcUDINT p = 0; p < task.divider_; p++)
+  {
+    double load = 0;
+    for (mcUDINT t = 0; t < task_num_; t++)
+    {
+      const Task& other = tasks_[t];
+      const mcUDINT g   = std::gcd(task.divider_, other.divider_);
+      for (mcUDINT m = 0; m < other.member_num_; m++)
+        if (p % g == other.members_[m].phase_ % g)
+          load += static_cast<double>(g) / other.divider_;
+    }
+    if (best_load < 0 || load < best_load)
+    {
+      best_load  = load;
+      best_phase = p;
+    }
+  }
+  return best_phase;
+}
+
+mcBOOL TaskScheduler::addMember(mcDINT index, void* obj, RunFunc run)
+{
+  if (index < 0 || static_cast<mcUDINT>(index) >= task_num_ || !obj)
+  {
+    INFO_PRINT("TaskScheduler::addMember: invalid task %d or member.\n",
+               index);
+    return mcFALSE;
+  }
+
+  Task& task = tasks_[index];
+  if (task.member_num_ >= TASK_MEMBER_MAX_NUM)
+  {
+    INFO_PRINT("TaskScheduler::addMember: task %d cannot hold more than %d "
+               "members.\n",
+               index, TASK_MEMBER_MAX_NUM);
+    return mcFALSE;
+  }
+
+  const mcUDINT phase = choosePhase(task);
+
+  // Insert sorted by phase, members of one phase keep their added order
+  mcUDINT pos = task.member_num_;
+  while (pos > 0 && task.members_[pos - 1].phase_ > phase)
+  {
+    task.members_[pos] = task.members_[pos - 1];
+    pos--;
+  }
+  task.members_[pos] = { obj, run, phase };
+  task.member_num_++;
+
+  DEBUG_PRINT("TaskScheduler::addMember: task %d, phase %u of %u\n", index,
+              phase, task.divider_);
+  return mcTRUE;
+}
+
+void TaskScheduler::runCycle()
+{
+  for (mcUDINT i = 0; i < task_num_; i++)
+  {
+    Task& task         = tasks_[order_[i]];
+    const mcUDINT slot = cycle_ % task.divider_;
+    if (slot == 0)
+      task.cursor_ = 0;
+
+    // Slots only grow until the period wraps, so a cursor finds the members
+    // due now without scanning the whole task
+    while (task.cursor_ < task.member_num_ &&
+           task.members_[task.cursor_].phase_ < slot)
+      task.cursor_++;
+    while (task.cursor_ < task.member_num_ &&
+           task.members_[task.cursor_].phase_ == slot)
+    {
+      const Member& member = task.members_[task.cursor_++];
+      member.run_(member.obj_);
+    }
+  }
+  cycle_++;
+}
+
+void TaskScheduler::reset()
+{
+  cycle_ = 0;
+  for (mcUDINT i = 0; i < task_num_; i++)
+    tasks_[i].cursor_ = 0;
+}
+
+mcULINT TaskScheduler::getCycleCount() const
+{
+  return cycle_;
+}
+
+mcUDINT TaskScheduler::getTaskNum() const
+{
+  return task_num_;
+}
+
+mcUDINT TaskScheduler::getMemberNum(mcDINT task) const
+{
+  if (task < 0 || static_cast<mcUDINT>(task) >= task_num_)
+    return 0;
+  return tasks_[task].member_num_;
+}
+
+mcUDINT TaskScheduler::getPhase(mcDINT task, mcUDINT member) const
+{
+  if (task < 0 || static_cast<mcUDINT>(task) >= task_num_ ||
+      member >= tasks_[task].member_num_)
+    return 0;
+  return tasks_[task].members_[member].phase_;
+}
+
+mcUDINT TaskScheduler::getPeakLoad(mcUDINT horizon) const
+{
+  mcULINT period = 1;
+  for (mcUDINT t = 0; t < task_num_; t++)
+  {
+    period = std::lcm(period, static_cast<mcULINT>(tasks_[t].divider_));
+    if (period >= horizon)
+    {
+      period = horizon;
+      break;
+    }
+  }
+
+  mcUDINT peak = 0;
+  for (mcULINT c = 0; c < period; c++)
+  {
+    mcUDINT load = 0;
+    for (mcUDINT t = 0; t < task_num_; t++)
+      for (mcUDINT m = 0; m < tasks_[t].member_num_; m++)
+        if (c % tasks_[t].divider_ == tasks_[t].members_[m].phase_)
+          load++;
+    peak = std::max(peak, load);
+  }
+  return peak;
+}
+
+}  // namespace RTmotion
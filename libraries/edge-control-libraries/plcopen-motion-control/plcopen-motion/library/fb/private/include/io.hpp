@@ -50,6 +50,24 @@ typedef struct
   mcUINT n_pdo;
 } MC_IO_INFO;
 
+// Location of one IO bit in the process data
+typedef struct
+{
+  mcUDINT offset;  // byte offset from the process data base
+  mcUSINT mask;    // bit mask within that byte, 0 for unsupported entries
+} IO_BIT_ADDR;
+
+// IO layout compiled once after initialization, and the packed bit image of
+// all IOs of one direction refreshed once per cycle
+typedef struct
+{
+  std::vector<IO_BIT_ADDR> bits;  // flat bit index -> process data location
+  std::vector<mcUDINT> pdo_base;  // first flat bit of each PDO, n_pdo + 1 items
+  std::vector<mcULINT> image;     // bit values, 64 IOs per word
+  std::vector<mcULINT> rising;    // inputs that changed 0->1 in the last cycle
+  std::vector<mcULINT> falling;   // inputs that changed 1->0 in the last cycle
+} IO_BIT_IMAGE;
+
 class McIO
 {
 public:
@@ -62,18 +80,17 @@ public:
   // get parameters
   virtual MC_IO_ERROR_CODE getErrorCode();
 
-  /* read IO value */
+  /* read IO value
+   * Reads return the image of the last runCycle(), inputs changed since then
+   * are not visible until the next cycle. Outputs written by writeOutputData()
+   * are visible right away. */
   virtual MC_ERROR_CODE readInputOutputData(
       mcUINT ioNum, mcUSINT bitNum, mcBOOL& io_data,
       IO_TYPE ioType);  // bitNum starts from 0, write input data in io_data
-  virtual MC_IO_ERROR_CODE getIOValueByEntry(PDO_ENTRY_INFO pdo_entry,
-                                             mcUSINT bitNum, mcBOOL& io_data);
 
   /* write IO value */
   virtual MC_ERROR_CODE writeOutputData(mcUINT pdoID, mcUSINT bitNum,
                                         mcBOOL data);  // bitNum starts from 0
-  virtual MC_IO_ERROR_CODE setIOValueByEntry(PDO_ENTRY_INFO pdo_entry,
-                                             mcUSINT bitNum, mcBOOL data);
 
   virtual mcBOOL initializeIO(mcUDINT slave_index);  // initialize IO class as
                                                      // one 8-bit input with a
@@ -90,12 +107,30 @@ public:
 
   void freePdoEntry(PDO_ENTRY_INFO* pdo_entry);
   void freeInputOutputInfo(MC_IO_INFO& io_info);
-  virtual void runCycle();
+  virtual void runCycle();  // refresh the bit images, call after PDO receive
+
+  /* Bit image */
+  mcBOOL compileIOLayout();  // build bit tables from the sorted PDO info,
+                             // bits of entries that are not 8, 16, 32 or 64
+                             // bits long cannot be accessed
+  void updateIOImage();      // gather all IO bits into the packed images
+  MC_ERROR_CODE getBitIndex(mcUINT ioNum, mcUSINT bitNum, IO_TYPE ioType,
+                            mcUDINT& index);  // flat index into the image
+  mcBOOL getRisingEdge(mcUDINT index, IO_TYPE ioType);   // inputs only
+  mcBOOL getFallingEdge(mcUDINT index, IO_TYPE ioType);  // inputs only
+  const IO_BIT_IMAGE& getIOImage(IO_TYPE ioType);
 
 protected:
+  // Base address the PDO entry offsets refer to, nullptr if not mapped yet
+  virtual mcUSINT* getProcessData(IO_TYPE ioType);
+
   MC_IO_ERROR_CODE error_code_;
   MC_IO_INFO input_info_;   // store all input PDOs of this slave
   MC_IO_INFO output_info_;  // store all output PDOs of this slave
+  IO_BIT_IMAGE input_image_;
+  IO_BIT_IMAGE output_image_;
+  std::vector<mcUSINT> input_data_;  // simulated process data of McIO
+  std::vector<mcUSINT> output_data_;
 
 private:
   mcUINT device_addr_;
@@ -9,6 +9,8 @@
  */
 
 #include <fb/private/include/io.hpp>
+#include <algorithm>
+#include <stdio.h>
 #include <string.h>
 
 namespace RTmotion
@@ -24,7 +26,13 @@ McIO::~McIO()
   freeInputOutputInfo(output_info_);
 }
 
-McIO::McIO(const McIO& other) : input_info_(), output_info_()
+McIO::McIO(const McIO& other)
+  : input_info_()
+  , output_info_()
+  , input_image_(other.input_image_)
+  , output_image_(other.output_image_)
+  , input_data_(other.input_data_)
+  , output_data_(other.output_data_)
 {
   error_code_  = other.error_code_;
   device_addr_ = other.device_addr_;
@@ -40,6 +48,10 @@ McIO& McIO::operator=(const McIO& other)
     device_addr_ = other.device_addr_;
     cpyMcIOInfo(input_info_, other.input_info_);
     cpyMcIOInfo(output_info_, other.output_info_);
+    input_image_  = other.input_image_;
+    output_image_ = other.output_image_;
+    input_data_   = other.input_data_;
+    output_data_  = other.output_data_;
   }
   return *this;
 }
@@ -116,54 +128,19 @@ MC_IO_ERROR_CODE McIO::getErrorCode()
 MC_ERROR_CODE McIO::readInputOutputData(mcUINT ioNum, mcUSINT bitNum,
                                         mcBOOL& io_data, IO_TYPE ioType)
 {
-  PDO_INFO pdo;
-  PDO_ENTRY_INFO pdo_entry;
-  mcUSINT bit_num_count = bitNum;
-  /* check input/output type */
-  if (ioType == typeInput)
+  mcUDINT index;
+  MC_ERROR_CODE ret = getBitIndex(ioNum, bitNum, ioType, index);
+  if (ret != mcErrorCodeGood)
   {
-    pdo = input_info_.pdo_info[ioNum];
-  }
-  else if (ioType == typeOutput)
-  {
-    pdo = output_info_.pdo_info[ioNum];
-  }
-  else
-  {
-    return mcErrorCodeIOTypeError;
-  }
-  /* read operation */
-  for (mcUINT i = 0; i < pdo.n_entries; i++)
-  {
-    if (bit_num_count < pdo.pdo_entry_info[i].bitlen)
-    {
-      pdo_entry = pdo.pdo_entry_info[i];
-      MC_IO_ERROR_CODE op_error =
-          getIOValueByEntry(pdo_entry, bit_num_count, io_data);
-      return ioErrorToMcError(op_error);
-    }
-    else
-    {
-      if (i == pdo.n_entries - 1)
-      {
-        return mcErrorCodeIODataBitLengthError;
-      }
-      else
-      {
-        bit_num_count = bit_num_count - pdo.pdo_entry_info[i].bitlen;
-      }
-    }
+    return ret;
   }
+  /* read operation from the image of this cycle */
+  const IO_BIT_IMAGE& io_image = getIOImage(ioType);
+  io_data =
+      static_cast<mcBOOL>((io_image.image[index >> 6] >> (index & 63)) & 1);
   return mcErrorCodeGood;
 }
 
-MC_IO_ERROR_CODE McIO::getIOValueByEntry(PDO_ENTRY_INFO pdo_entry,
-                                         mcUSINT bitNum, mcBOOL& io_data)
-{
-  io_data = static_cast<mcBOOL>((pdo_entry.value >> bitNum) & 1);
-  return mcIONoError;
-}
-
 MC_ERROR_CODE McIO::writeOutputData(mcUINT outputNum, mcUSINT bitNum,
                                     mcBOOL data)
 {
@@ -172,56 +149,34 @@ MC_ERROR_CODE McIO::writeOutputData(mcUINT outputNum, mcUSINT bitNum,
   {
     return ioErrorToMcError(error_code_);
   }
-  /* validate pdoID */
-  if (outputNum > output_info_.n_pdo - 1)
+
+  mcUDINT index;
+  MC_ERROR_CODE ret = getBitIndex(outputNum, bitNum, typeOutput, index);
+  if (ret != mcErrorCodeGood)
   {
-    return mcErrorCodeIONumberError;
+    return ret;
   }
 
-  PDO_INFO pdo_info = output_info_.pdo_info[outputNum];
-  PDO_ENTRY_INFO pdo_entry;
-  mcUSINT bit_num_count = bitNum;
-
-  for (mcUINT i = 0; i < pdo_info.n_entries; i++)
+  mcUSINT* data_base = getProcessData(typeOutput);
+  if (!data_base)
   {
-    if (bit_num_count < pdo_info.pdo_entry_info[i].bitlen)
-    {
-      pdo_entry = pdo_info.pdo_entry_info[i];
-      MC_IO_ERROR_CODE op_error =
-          setIOValueByEntry(pdo_entry, bit_num_count, data);
-      return ioErrorToMcError(op_error);
-    }
-    else
-    {
-      if (i == pdo_info.n_entries - 1)
-      {
-        return ioErrorToMcError(mcIODataBitLengthError);
-      }
-      else
-      {
-        bit_num_count = bit_num_count - pdo_info.pdo_entry_info[i].bitlen;
-      }
-    }
+    return ioErrorToMcError(mcIOInvalidOffsetError);
   }
-  return mcErrorCodeGood;
-}
 
-MC_IO_ERROR_CODE McIO::setIOValueByEntry(PDO_ENTRY_INFO pdo_entry,
-                                         mcUSINT bitNum, mcBOOL data)
-{
-  mcULINT value = pdo_entry.value;
-  mcUDINT index = pdo_entry.index;
+  /* write the process data and keep the output image in step with it */
+  const IO_BIT_ADDR& addr = output_image_.bits[index];
+  const mcULINT bit       = 1ULL << (index & 63);
   if (data == mcTRUE)
   {
-    output_info_.pdo_info[0].pdo_entry_info[index].value =
-        (value | (1 << bitNum));
+    data_base[addr.offset] |= addr.mask;
+    output_image_.image[index >> 6] |= bit;
   }
   else
   {
-    output_info_.pdo_info[0].pdo_entry_info[index].value =
-        (value & (~(1 << bitNum)));
+    data_base[addr.offset] &= ~addr.mask;
+    output_image_.image[index >> 6] &= ~bit;
   }
-  return mcIONoError;
+  return mcErrorCodeGood;
 }
 
 mcBool McIO::initializeIO(mcUDINT slave_index)
@@ -314,7 +269,7 @@ mcBool McIO::initializeIO(mcUDINT slave_index)
   }
   output_info_.pdo_info[0] = output0;
 
-  return mcTRUE;
+  return compileIOLayout();
 }
 
 MC_ERROR_CODE McIO::ioErrorToMcError(MC_IO_ERROR_CODE errorCode)
@@ -328,7 +283,160 @@ MC_ERROR_CODE McIO::ioErrorToMcError(MC_IO_ERROR_CODE errorCode)
 
 void McIO::runCycle()
 {
-  // update data
+  updateIOImage();
+}
+
+mcUSINT* McIO::getProcessData(IO_TYPE ioType)
+{
+  std::vector<mcUSINT>& data =
+      (ioType == typeInput) ? input_data_ : output_data_;
+  return data.empty() ? nullptr : data.data();
+}
+
+static void compileIOBitImage(const MC_IO_INFO& io_info,
+                              IO_BIT_IMAGE& io_image,
+                              std::vector<mcUSINT>& sim_data, bool edges)
+{
+  io_image.bits.clear();
+  io_image.pdo_base.assign(1, 0);
+  sim_data.clear();
+
+  for (mcUINT i = 0; io_info.pdo_info && i < io_info.n_pdo; i++)
+  {
+    const PDO_INFO& pdo = io_info.pdo_info[i];
+    for (mcUINT j = 0; pdo.pdo_entry_info && j < pdo.n_entries; j++)
+    {
+      const PDO_ENTRY_INFO& entry = pdo.pdo_entry_info[j];
+      // Entry offsets are byte offsets, shorter entries share a byte at a
+      // bit position the layout does not know. Their bits keep their place
+      // in the numbering with an empty mask, so only accessing them fails.
+      if (entry.bitlen != 8 && entry.bitlen != 16 && entry.bitlen != 32 &&
+          entry.bitlen != 64)
+      {
+        printf("Unsupported bitlength %u for IO 0x%X:%u, entry skipped\n",
+               entry.bitlen, entry.index, entry.subindex);
+        io_image.bits.insert(io_image.bits.end(), entry.bitlen, { 0, 0 });
+        continue;
+      }
+      // Bit n of an entry lives in byte n / 8 of its little-endian value
+      for (mcUDINT bit = 0; bit < entry.bitlen; bit++)
+        io_image.bits.push_back(
+            { entry.offset + bit / 8, static_cast<mcUSINT>(1 << (bit % 8)) });
+
+      // McIO keeps the process data itself, seeded from the entry values
+      mcUDINT bytes = (entry.bitlen + 7) / 8;
+      if (sim_data.size() < entry.offset + bytes)
+        sim_data.resize(entry.offset + bytes, 0);
+      for (mcUDINT b = 0; b < bytes && b < sizeof(entry.value); b++)
+        sim_data[entry.offset + b] |=
+            static_cast<mcUSINT>(entry.value >> (8 * b));
+    }
+    io_image.pdo_base.push_back(io_image.bits.size());
+  }
+
+  size_t words = (io_image.bits.size() + 63) / 64;
+  io_image.image.assign(words, 0);
+  io_image.rising.assign(edges ? words : 0, 0);
+  io_image.falling.assign(edges ? words : 0, 0);
+}
+
+mcBOOL McIO::compileIOLayout()
+{
+  // Outputs change by writeOutputData() which updates the image right away,
+  // so edges are only tracked for inputs
+  compileIOBitImage(input_info_, input_image_, input_data_, true);
+  compileIOBitImage(output_info_, output_image_, output_data_, false);
+  updateIOImage();
+  // Nothing changed before the first cycle
+  std::fill(input_image_.rising.begin(), input_image_.rising.end(), 0);
+  return mcTRUE;
+}
+
+static void updateIOBitImage(const mcUSINT* data_base, IO_BIT_IMAGE& io_image)
+{
+  if (!data_base)
+  {
+    return;
+  }
+
+  const IO_BIT_ADDR* addr = io_image.bits.data();
+  const size_t n_bits     = io_image.bits.size();
+  for (size_t w = 0; w < io_image.image.size(); w++)
+  {
+    // Gather 64 IO bits into one word, then detect edges for all of them
+    mcULINT value = 0;
+    size_t n      = std::min<size_t>(64, n_bits - w * 64);
+    for (size_t b = 0; b < n; b++, addr++)
+      value |= static_cast<mcULINT>((data_base[addr->offset] & addr->mask) != 0)
+               << b;
+
+    if (!io_image.rising.empty())
+    {
+      mcULINT last        = io_image.image[w];
+      io_image.rising[w]  = value & ~last;
+      io_image.falling[w] = ~value & last;
+    }
+    io_image.image[w] = value;
+  }
+}
+
+void McIO::updateIOImage()
+{
+  updateIOBitImage(getProcessData(typeInput), input_image_);
+  updateIOBitImage(getProcessData(typeOutput), output_image_);
+}
+
+MC_ERROR_CODE McIO::getBitIndex(mcUINT ioNum, mcUSINT bitNum, IO_TYPE ioType,
+                                mcUDINT& index)
+{
+  if (ioType != typeInput && ioType != typeOutput)
+  {
+    return mcErrorCodeIOTypeError;
+  }
+
+  const IO_BIT_IMAGE& io_image = getIOImage(ioType);
+  if (ioNum + 1u >= io_image.pdo_base.size())
+  {
+    return mcErrorCodeIONumberError;
+  }
+  if (io_image.pdo_base[ioNum] + bitNum >= io_image.pdo_base[ioNum + 1])
+  {
+    return mcErrorCodeIODataBitLengthError;
+  }
+
+  index = io_image.pdo_base[ioNum] + bitNum;
+  // Bit of an entry the layout does not support
+  if (!io_image.bits[index].mask)
+  {
+    return mcErrorCodeIODataBitLengthError;
+  }
+  return mcErrorCodeGood;
+}
+
+mcBOOL McIO::getRisingEdge(mcUDINT index, IO_TYPE ioType)
+{
+  const IO_BIT_IMAGE& io_image = getIOImage(ioType);
+  if (index >= io_image.rising.size() * 64 || index >= io_image.bits.size())
+  {
+    return mcFALSE;
+  }
+  return static_cast<mcBOOL>((io_image.rising[index >> 6] >> (index & 63)) & 1);
+}
+
+mcBOOL McIO::getFallingEdge(mcUDINT index, IO_TYPE ioType)
+{
+  const IO_BIT_IMAGE& io_image = getIOImage(ioType);
+  if (index >= io_image.falling.size() * 64 || index >= io_image.bits.size())
+  {
+    return mcFALSE;
+  }
+  return static_cast<mcBOOL>(
+      (io_image.falling[index >> 6] >> (index & 63)) & 1);
+}
+
+const IO_BIT_IMAGE& McIO::getIOImage(IO_TYPE ioType)
+{
+  return (ioType == typeInput) ? input_image_ : output_image_;
 }
 
 // Bubble Sort PDO Entry in an ascending order of subindex
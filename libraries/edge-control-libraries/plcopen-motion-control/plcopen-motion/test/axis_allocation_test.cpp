@@ -0,0 +1,112 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2025 Intel Corporation
+
+/**
+ * @file axis_allocation_test.cpp
+ *
+ * Maintainer: Yu Yan <yu.yan@intel.com>
+ *
+ */
+
+#include <fb/common/include/axis.hpp>
+#include <fb/public/include/fb_power.hpp>
+#include <fb/public/include/fb_move_relative.hpp>
+#include <fb/private/include/fb_move_superimposed.hpp>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "gtest/gtest.h"
+
+using namespace RTmotion;
+
+// Heap allocations made while count_allocations is set. The replaced
+// allocation functions apply to the whole binary, so it only holds tests
+// that count allocations.
+static std::atomic<bool> count_allocations(false);
+static std::atomic<size_t> heap_allocations(0);
+
+void* operator new(std::size_t size)
+{
+  if (count_allocations)
+    heap_allocations++;
+  void* ptr = std::malloc(size ? size : 1);
+  if (ptr == nullptr)
+    throw std::bad_alloc();
+  return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t /*size*/) noexcept
+{
+  std::free(ptr);
+}
+
+// Moves replan in the pooled planners, the cycle never allocates
+TEST(AxisAllocationTest, MoveWithoutAllocation)
+{
+  AxisConfig config;
+  AXIS_REF axis = new Axis();
+  axis->setAxisId(1);
+  axis->setAxisConfig(&config);
+  Servo* servo = new Servo();
+  axis->setServo(servo);
+
+  FbPower fb_power;
+  fb_power.setAxis(axis);
+  fb_power.setEnable(mcTRUE);
+  fb_power.setEnablePositive(mcTRUE);
+  fb_power.setEnableNegative(mcTRUE);
+
+  FbMoveRelative fb_move_rel;
+  fb_move_rel.setAxis(axis);
+  fb_move_rel.setExecute(mcFALSE);
+  fb_move_rel.setDistance(3.14);
+  fb_move_rel.setVelocity(1.57);
+  fb_move_rel.setAcceleration(3.14);
+  fb_move_rel.setDeceleration(3.14);
+  fb_move_rel.setJerk(50);
+
+  FbMoveSuperimposed fb_superimposed;
+  fb_superimposed.setAxis(axis);
+  fb_superimposed.setExecute(mcFALSE);
+  fb_superimposed.setDistance(0.5);
+  fb_superimposed.setVelocityDiff(1.0);
+  fb_superimposed.setAcceleration(3.14);
+  fb_superimposed.setDeceleration(3.14);
+  fb_superimposed.setJerk(50);
+
+  heap_allocations  = 0;
+  count_allocations = true;
+  double timeout    = 0;
+  while (fb_move_rel.isDone() == mcFALSE && timeout < 5)
+  {
+    axis->runCycle();
+    fb_power.runCycle();
+    fb_move_rel.runCycle();
+    fb_superimposed.runCycle();
+    timeout += 0.001;
+
+    if (fb_move_rel.isEnabled() == mcFALSE &&
+        fb_power.getPowerStatus() == mcTRUE)
+      fb_move_rel.setExecute(mcTRUE);
+    if (timeout > 0.5)
+      fb_superimposed.setExecute(mcTRUE);
+  }
+  count_allocations = false;
+
+  ASSERT_TRUE(fb_move_rel.isDone() == mcTRUE);
+  ASSERT_TRUE(fb_superimposed.isDone() == mcTRUE);
+  ASSERT_EQ(heap_allocations.load(), 0u);
+  delete servo;
+  delete axis;
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,154 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2025 Intel Corporation
+
+/**
+ * @file axis_snapshot_test.cpp
+ *
+ * Maintainer: Yu Yan <yu.yan@intel.com>
+ *
+ */
+
+#include <fb/common/include/axis.hpp>
+#include <fb/common/include/axis_snapshot.hpp>
+#include <fb/public/include/fb_power.hpp>
+#include <fb/public/include/fb_move_velocity.hpp>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include "gtest/gtest.h"
+
+using namespace RTmotion;
+
+class AxisSnapshotTest : public ::testing::Test
+{
+protected:
+  AxisSnapshotTest()
+  {
+  }
+
+  ~AxisSnapshotTest() override
+  {
+  }
+
+  void SetUp() override
+  {
+    table_.reset(new AxisSnapshotTable());
+  }
+
+  void TearDown() override
+  {
+  }
+
+  std::unique_ptr<AxisSnapshotTable> table_;
+};
+
+TEST_F(AxisSnapshotTest, PublishAxisState)
+{
+  AxisConfig config;
+  Axis axis;
+  Servo servo;
+  axis.setAxisId(3);
+  axis.setAxisConfig(&config);
+  axis.setServo(&servo);
+
+  AxisSnapshot snapshot;
+  ASSERT_EQ(table_->read(3, snapshot), mcFALSE);
+  axis.setSnapshotTable(table_.get(), 3);
+
+  FbPower fb_power;
+  fb_power.setAxis(&axis);
+  fb_power.setEnable(mcTRUE);
+  fb_power.setEnablePositive(mcTRUE);
+  fb_power.setEnableNegative(mcTRUE);
+
+  FbMoveVelocity fb_move_vel;
+  fb_move_vel.setAxis(&axis);
+  fb_move_vel.setVelocity(1);
+  fb_move_vel.setAcceleration(10);
+  fb_move_vel.setDeceleration(10);
+  fb_move_vel.setJerk(100);
+
+  for (int i = 0; i < 500; i++)
+  {
+    axis.runCycle();
+    fb_power.runCycle();
+    fb_move_vel.runCycle();
+    if (fb_power.getPowerStatus() == mcTRUE)
+      fb_move_vel.setExecute(mcTRUE);
+  }
+
+  // The snapshot is the state at the end of the last axis cycle
+  ASSERT_EQ(table_->read(3, snapshot), mcTRUE);
+  ASSERT_EQ(table_->getVersion(3), 500u);
+  ASSERT_EQ(snapshot.cycle_, 500u);
+  ASSERT_EQ(snapshot.axis_id_, 3);
+  ASSERT_EQ(snapshot.power_, mcTRUE);
+  ASSERT_EQ(snapshot.error_, mcErrorCodeGood);
+  ASSERT_EQ(snapshot.state_, mcContinuousMotion);
+  ASSERT_EQ(snapshot.motion_, mcMoveVelocityMode);
+  ASSERT_EQ(snapshot.queued_, 0);  // Held after reaching the velocity
+  ASSERT_EQ(snapshot.pos_, axis.toUserPos());
+  ASSERT_EQ(snapshot.vel_cmd_, axis.toUserVelCmd());
+  ASSERT_GT(snapshot.vel_cmd_, 0);
+
+  // Other slots are untouched
+  ASSERT_EQ(table_->read(2, snapshot), mcFALSE);
+  ASSERT_EQ(table_->read(AXIS_SNAPSHOT_MAX_NUM, snapshot), mcFALSE);
+}
+
+TEST_F(AxisSnapshotTest, ConcurrentReaders)
+{
+  // Every field of a published snapshot carries the same value, a torn read
+  // would mix two of them
+  const mcULINT publish_num = 200000;
+  std::atomic<bool> running(true);
+  std::atomic<mcULINT> torn(0), reads(0);
+
+  auto reader = [&]() {
+    AxisSnapshot snapshot;
+    while (running.load())
+    {
+      for (mcUDINT i = 0; i < 4; i++)
+      {
+        if (table_->read(i, snapshot) == mcFALSE)
+          continue;
+        reads++;
+        const mcLREAL value = static_cast<mcLREAL>(snapshot.cycle_);
+        if (snapshot.stamp_ != value || snapshot.pos_ != value ||
+            snapshot.vel_ != value || snapshot.acc_cmd_ != value ||
+            snapshot.axis_id_ != i)
+          torn++;
+      }
+    }
+  };
+  std::thread reader_1(reader), reader_2(reader);
+
+  AxisSnapshot snapshot = {};
+  for (mcULINT n = 1; n <= publish_num; n++)
+  {
+    const mcLREAL value = static_cast<mcLREAL>(n);
+    snapshot.cycle_     = n;
+    snapshot.stamp_ = snapshot.pos_ = snapshot.vel_ = snapshot.acc_cmd_ =
+        value;
+    for (mcUDINT i = 0; i < 4; i++)
+    {
+      snapshot.axis_id_ = i;
+      table_->publish(i, snapshot);
+    }
+  }
+  running.store(false);
+  reader_1.join();
+  reader_2.join();
+
+  ASSERT_EQ(torn.load(), 0u);
+  ASSERT_GT(reads.load(), 0u);
+  ASSERT_EQ(table_->getVersion(0), publish_num);
+  ASSERT_EQ(table_->read(0, snapshot), mcTRUE);
+  ASSERT_EQ(snapshot.cycle_, publish_num);
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
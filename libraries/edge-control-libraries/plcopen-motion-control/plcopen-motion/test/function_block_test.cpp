@@ -2195,6 +2195,197 @@ TEST_F(FunctionBlockTest, MC_SetOverride)
   printf("FB test end. Delete axis and servo.\n");
 }
 
+// Test MC_SetOverride applied by time scaling the active move
+TEST_F(FunctionBlockTest, MC_SetOverrideTimeScaling)
+{
+  AxisConfig config;
+  config.override_time_scaling_ = mcTRUE;
+  AXIS_REF axis;
+  axis = new Axis();
+  axis->setAxisId(1);
+  axis->setAxisConfig(&config);
+
+  Servo* servo;
+  servo = new Servo();
+  axis->setServo(servo);
+
+  FbPower fb_power;
+  fb_power.setAxis(axis);
+  fb_power.setEnable(mcTRUE);
+  fb_power.setEnablePositive(mcTRUE);
+  fb_power.setEnableNegative(mcTRUE);
+
+  // Long ramp so that the override arrives while the profile is active
+  FbMoveVelocity mov_vel;
+  mov_vel.setAxis(axis);
+  mov_vel.setVelocity(200);
+  mov_vel.setAcceleration(50);
+  mov_vel.setDeceleration(50);
+  mov_vel.setJerk(500);
+  mov_vel.setBufferMode(mcAborting);
+
+  // Halving the velocity with full acceleration and jerk fits the limits of
+  // the planned profile, so the ramp is slowed down in time
+  FbSetOverride fb_set_override;
+  fb_set_override.setAxis(axis);
+  fb_set_override.setVelFactor(0.5);
+  fb_set_override.setAccFactor(1);
+  fb_set_override.setJerkFactor(1);
+
+  double t        = 0;
+  double last_acc = 0;
+  double max_jerk = 0;
+  double vel_1s   = 0;
+  while (t < 12)
+  {
+    axis->runCycle();
+    fb_power.runCycle();
+    mov_vel.runCycle();
+    fb_set_override.runCycle();
+
+    if (mov_vel.isEnabled() == mcFALSE && fb_power.getPowerStatus() == mcTRUE)
+      mov_vel.setExecute(mcTRUE);
+
+    if (fabs(t - 1.0) < 0.0001)
+    {
+      vel_1s = axis->toUserVelCmd();
+      fb_set_override.setEnable(mcTRUE);
+    }
+
+    // Commanded acceleration stays continuous through the transition, a step
+    // in the time scale would show up as a jerk spike of 1e4 and more
+    if (t > 0.9 && t < 3)
+      max_jerk = fmax(max_jerk, fabs(axis->toUserAccCmd() - last_acc) / 0.001);
+    last_acc = axis->toUserAccCmd();
+
+    t += 0.001;
+  }
+
+  ASSERT_GT(vel_1s, 10);
+  ASSERT_LT(vel_1s, 100);
+  ASSERT_EQ(mov_vel.isInVelocity(), mcTRUE);
+  ASSERT_LT(fabs(axis->toUserVelCmd() - 100), 0.01);
+  ASSERT_LT(max_jerk, 2000);
+
+  delete servo;
+  delete axis;
+  servo = nullptr;
+  axis  = nullptr;
+  printf("FB test end. Delete axis and servo.\n");
+}
+
+// Run a 100 unit move with the velocity halved at 0.4 s, and check that the
+// commanded position follows the integral of the commanded velocity. The fast
+// scale ramp would add up to 1000 to the acceleration at full velocity.
+static void runTimeScaledMove(FbAxisMotion& move, double end_pos)
+{
+  AxisConfig config;
+  config.override_time_scaling_ = mcTRUE;
+  config.override_scale_rate_   = 10;
+  config.override_scale_acc_    = 1000;
+  AXIS_REF axis = new Axis();
+  axis->setAxisId(1);
+  axis->setAxisConfig(&config);
+  Servo* servo = new Servo();
+  axis->setServo(servo);
+
+  FbPower fb_power;
+  fb_power.setAxis(axis);
+  fb_power.setEnable(mcTRUE);
+  fb_power.setEnablePositive(mcTRUE);
+  fb_power.setEnableNegative(mcTRUE);
+
+  // Absolute moves need a homed axis
+  FbSetPosition set_position;
+  set_position.setAxis(axis);
+  set_position.setMode(mcSetPositionModeRelative);
+  set_position.setPosition(0);
+
+  move.setAxis(axis);
+  move.setVelocity(100);
+  move.setAcceleration(500);
+  move.setDeceleration(500);
+  move.setJerk(5000);
+
+  FbSetOverride fb_set_override;
+  fb_set_override.setAxis(axis);
+  fb_set_override.setVelFactor(0.5);
+  fb_set_override.setAccFactor(1);
+  fb_set_override.setJerkFactor(1);
+
+  double t          = 0;
+  double last_vel   = 0;
+  double last_pos   = 0;
+  double integral   = 0;
+  double max_error  = 0;
+  double vel_cruise = 0;
+  double pos_rate   = 0;
+  double max_acc    = 0;
+  while (move.isDone() == mcFALSE && t < 5)
+  {
+    axis->runCycle();
+    fb_power.runCycle();
+    set_position.runCycle();
+    move.runCycle();
+    fb_set_override.runCycle();
+
+    if (set_position.isEnabled() == mcFALSE &&
+        fb_power.getPowerStatus() == mcTRUE)
+      set_position.setEnable(mcTRUE);
+    if (move.isEnabled() == mcFALSE && set_position.isEnabled() == mcTRUE)
+      move.setExecute(mcTRUE);
+    if (fabs(t - 0.4) < 0.0001)
+      fb_set_override.setEnable(mcTRUE);
+
+    double pos = axis->toUserPosCmd();
+    double vel = axis->toUserVelCmd();
+    if (move.isEnabled() == mcTRUE)
+    {
+      integral += (vel + last_vel) / 2 * 0.001;
+      max_error = fmax(max_error, fabs(pos - integral));
+      max_acc   = fmax(max_acc, fabs(axis->toUserAccCmd()));
+    }
+    else
+      integral = pos;
+    if (fabs(t - 1.0) < 0.0001)
+    {
+      vel_cruise = vel;
+      pos_rate   = (pos - last_pos) / 0.001;
+    }
+    last_vel = vel;
+    last_pos = pos;
+    t += 0.001;
+  }
+
+  ASSERT_EQ(move.isDone(), mcTRUE);
+  ASSERT_LT(fabs(axis->toUserPosCmd() - end_pos), 0.01);
+  // Halved velocity, and the position moves at that velocity
+  ASSERT_LT(fabs(vel_cruise - 50), 0.01);
+  ASSERT_LT(fabs(pos_rate - 50), 0.1);
+  ASSERT_LT(max_error, 0.1);
+  // The scale change adds to the acceleration without exceeding the limit
+  ASSERT_LT(max_acc, 500 * 1.01);
+
+  delete servo;
+  delete axis;
+}
+
+// Test MC_SetOverride time scaling a Ruckig planned absolute move
+TEST_F(FunctionBlockTest, MC_SetOverrideTimeScalingAbsolute)
+{
+  FbMoveAbsolute move;
+  move.setPosition(100);
+  runTimeScaledMove(move, 100);
+}
+
+// Test MC_SetOverride time scaling a Ruckig planned relative move
+TEST_F(FunctionBlockTest, MC_SetOverrideTimeScalingRelative)
+{
+  FbMoveRelative move;
+  move.setDistance(100);
+  runTimeScaledMove(move, 100);
+}
+
 TEST_F(FunctionBlockTest, MC_DigitalCamSwitch)
 {
 #ifdef PLOT
@@ -2600,6 +2791,24 @@ TEST_F(FunctionBlockTest, MC_MoveSuperimposed3)
   printf("FB test end. Delete axis and servo.\n");
 }
 
+TEST_F(FunctionBlockTest, AxisFootprint)
+{
+  AxisFootprint footprint = Axis::getFootprint();
+  printf("Axis footprint: %u bytes, node %u bytes, planner %u bytes\n",
+         footprint.axis_, footprint.node_, footprint.planner_);
+
+  // Execution nodes reference the axis planner pool instead of embedding
+  // a planner each
+  static_assert(sizeof(ExecutionNode) < sizeof(trajectory_processing::AxisPlanner),
+                "Execution node embeds a planner");
+  static_assert(PLANNER_POOL_SIZE < NODE_BUFFER_MAX_SIZE,
+                "Planner pool as large as the node buffer");
+  ASSERT_EQ(footprint.axis_, sizeof(Axis));
+  ASSERT_LE(footprint.nodes_ + footprint.planners_, footprint.axis_);
+  // An axis with a planner per node would hold NODE_BUFFER_MAX_SIZE planners
+  ASSERT_LT(footprint.axis_, footprint.planner_ * NODE_BUFFER_MAX_SIZE);
+}
+
 int main(int argc, char** argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -30,6 +30,22 @@ mcUDINT output_bit_num  = 0;
 mcBOOL write_output_val = mcTRUE;
 mcBOOL result;
 
+// McIO with access to its simulated input process data
+class SimIO : public McIO
+{
+public:
+  void setInputByte(mcUSINT value)
+  {
+    input_data_[0] = value;
+  }
+
+  mcBOOL setInputBitLength(mcUDINT bitlen)
+  {
+    input_info_.pdo_info[0].pdo_entry_info[0].bitlen = bitlen;
+    return compileIOLayout();
+  }
+};
+
 class FunctionBlockTest : public ::testing::Test
 {
 protected:
@@ -177,4 +193,114 @@ TEST_F(FunctionBlockTest, DigitalOutputOperation)
   /* Post processing */
   delete my_io;
   printf("FB test end. Delete io object.\n");
-}
\ No newline at end of file
+}
+
+// Test the compiled bit image and its edge detection
+TEST_F(FunctionBlockTest, IOBitImage)
+{
+  SimIO my_io;
+  ASSERT_EQ(my_io.initializeIO(0), mcTRUE);
+
+  /* Flat bit index of each IO */
+  mcUDINT index = 0;
+  ASSERT_EQ(my_io.getBitIndex(0, 5, typeInput, index), mcErrorCodeGood);
+  ASSERT_EQ(index, 5u);
+  ASSERT_EQ(my_io.getBitIndex(0, 8, typeInput, index),
+            mcErrorCodeIODataBitLengthError);
+  ASSERT_EQ(my_io.getBitIndex(1, 0, typeOutput, index),
+            mcErrorCodeIONumberError);
+  ASSERT_EQ(my_io.getBitIndex(0, 0, typeInvalid, index),
+            mcErrorCodeIOTypeError);
+
+  /* Inputs are sampled once per cycle */
+  mcBOOL value = mcFALSE;
+  my_io.setInputByte(0x21);
+  my_io.readInputOutputData(0, 0, value, typeInput);
+  ASSERT_EQ(value, mcFALSE);
+  my_io.runCycle();
+  my_io.readInputOutputData(0, 0, value, typeInput);
+  ASSERT_EQ(value, mcTRUE);
+  ASSERT_EQ(my_io.getRisingEdge(0, typeInput), mcTRUE);
+  ASSERT_EQ(my_io.getRisingEdge(5, typeInput), mcTRUE);
+  ASSERT_EQ(my_io.getRisingEdge(1, typeInput), mcFALSE);
+  ASSERT_EQ(my_io.getIOImage(typeInput).image[0], 0x21u);
+
+  /* Edges last one cycle */
+  my_io.setInputByte(0x01);
+  my_io.runCycle();
+  ASSERT_EQ(my_io.getRisingEdge(0, typeInput), mcFALSE);
+  ASSERT_EQ(my_io.getFallingEdge(5, typeInput), mcTRUE);
+  my_io.runCycle();
+  ASSERT_EQ(my_io.getFallingEdge(5, typeInput), mcFALSE);
+
+  /* Outputs are visible right after writing */
+  ASSERT_EQ(my_io.writeOutputData(0, 7, mcTRUE), mcErrorCodeGood);
+  my_io.readInputOutputData(0, 7, value, typeOutput);
+  ASSERT_EQ(value, mcTRUE);
+  my_io.runCycle();
+  ASSERT_EQ(my_io.getIOImage(typeOutput).image[0], 0x80u);
+  ASSERT_EQ(my_io.writeOutputData(0, 7, mcFALSE), mcErrorCodeGood);
+  my_io.readInputOutputData(0, 7, value, typeOutput);
+  ASSERT_EQ(value, mcFALSE);
+  ASSERT_EQ(my_io.writeOutputData(0, 8, mcTRUE),
+            mcErrorCodeIODataBitLengthError);
+}
+
+// Test that reads see the inputs of the last cycle
+TEST_F(FunctionBlockTest, IOReadBeforeCycle)
+{
+  SimIO my_io;
+  ASSERT_EQ(my_io.initializeIO(0), mcTRUE);
+
+  FbReadDigitalInput fb_read_digital_input;
+  fb_read_digital_input.setIO(&my_io);
+  fb_read_digital_input.setInputNumber(0);
+  fb_read_digital_input.setBitNumber(3);
+  fb_read_digital_input.setEnable(mcTRUE);
+
+  /* The input changes, the block still reads the last image */
+  my_io.setInputByte(0x08);
+  fb_read_digital_input.runCycle();
+  ASSERT_EQ(fb_read_digital_input.isValid(), mcTRUE);
+  ASSERT_EQ(fb_read_digital_input.getValue(), mcFALSE);
+
+  /* After the IO cycle it reads the new value */
+  my_io.runCycle();
+  fb_read_digital_input.runCycle();
+  ASSERT_EQ(fb_read_digital_input.getValue(), mcTRUE);
+
+  /* And keeps it until the next cycle */
+  my_io.setInputByte(0x00);
+  fb_read_digital_input.runCycle();
+  ASSERT_EQ(fb_read_digital_input.getValue(), mcTRUE);
+  my_io.runCycle();
+  fb_read_digital_input.runCycle();
+  ASSERT_EQ(fb_read_digital_input.getValue(), mcFALSE);
+}
+
+// Test that entries of unsupported bit length are rejected
+TEST_F(FunctionBlockTest, IOUnsupportedBitLength)
+{
+  SimIO my_io;
+  ASSERT_EQ(my_io.initializeIO(0), mcTRUE);
+  ASSERT_EQ(my_io.setInputBitLength(16), mcTRUE);
+
+  mcUDINT index = 0;
+  ASSERT_EQ(my_io.getBitIndex(0, 15, typeInput, index), mcErrorCodeGood);
+
+  // A 1-bit entry does not fail the layout, only accessing it fails
+  mcBOOL value = mcFALSE;
+  ASSERT_EQ(my_io.setInputBitLength(1), mcTRUE);
+  ASSERT_EQ(my_io.getErrorCode(), mcIONoError);
+  ASSERT_EQ(my_io.readInputOutputData(0, 0, value, typeInput),
+            mcErrorCodeIODataBitLengthError);
+  ASSERT_EQ(my_io.getBitIndex(0, 1, typeInput, index),
+            mcErrorCodeIODataBitLengthError);
+  my_io.runCycle();
+
+  // The other IOs of the slave keep working
+  ASSERT_EQ(my_io.writeOutputData(0, 0, mcTRUE), mcErrorCodeGood);
+  ASSERT_EQ(my_io.readInputOutputData(0, 0, value, typeOutput),
+            mcErrorCodeGood);
+  ASSERT_EQ(value, mcTRUE);
+}
@@ -9,6 +9,7 @@
  */
 
 #include <fb/common/include/planner.hpp>
+#include <fb/common/include/motion_kernel.hpp>
 #include <thread>
 #include <fb/common/include/logging.hpp>
 #include "gtest/gtest.h"
@@ -302,6 +303,137 @@ TEST_F(PlannerTest, Test_Negative)
 #endif
 }
 
+// Tests switching planner type, only the active planner is kept
+TEST_F(PlannerTest, SwitchPlannerType)
+{
+  planner_.setFrequency(500);
+  planner_.setCondition(5, NAN, -1, 10, 0, 0, NAN, 5, 10, 30,
+                        RTmotion::mcOffLine);
+  ASSERT_EQ(planner_.getType(), RTmotion::mcOffLine);
+  ASSERT_EQ(planner_.planTrajectory(), RTmotion::mcErrorCodeGood);
+  double ta = planner_.getScurveProfile().Ta;
+
+  planner_.setCondition(0, 10, 0, 0, 0, 0, 2, 10, 10, 30, RTmotion::mcPoly5);
+  ASSERT_EQ(planner_.getType(), RTmotion::mcPoly5);
+  ASSERT_LT(abs(planner_.getScurveCondition().T - 2), 0.0001);
+
+  // Online planner is not selectable, the current one is kept
+  planner_.setCondition(0, 10, 0, 0, 0, 0, 2, 10, 10, 30, RTmotion::mcOnLine);
+  ASSERT_EQ(planner_.getType(), RTmotion::mcPoly5);
+
+  // Switching back rebuilds the planner from the condition alone
+  planner_.setCondition(5, NAN, -1, 10, 0, 0, NAN, 5, 10, 30,
+                        RTmotion::mcOffLine);
+  ASSERT_EQ(planner_.planTrajectory(), RTmotion::mcErrorCodeGood);
+  ASSERT_LT(abs(planner_.getScurveProfile().Ta - ta), 0.0001);
+
+  // Copies keep type and condition
+  traj_pro::AxisPlanner copy = planner_;
+  ASSERT_EQ(copy.getType(), RTmotion::mcOffLine);
+  ASSERT_LT(abs(copy.getScurveCondition().v1 - 10), 0.0001);
+}
+
+// Tests the look-ahead of the motion kernel on short blended moves. Each move
+// has to stay feasible with the junction velocities planned for it.
+TEST_F(PlannerTest, LookAheadJunctionVelocity)
+{
+  const double dist[5] = { 1, 1, 1, 1, -1 };
+  RTmotion::ExecutionNode nodes[5];
+  RTmotion::MotionKernel kernel;
+  kernel.setLookAheadDepth(8);
+  for (size_t i = 0; i < 5; i++)
+  {
+    nodes[i].setBasicParams(nullptr, RTmotion::mcMoveRelativeMode, dist[i],
+                            100, 10, 10, 30,
+                            i == 0 ? RTmotion::mcAborting :
+                                     RTmotion::mcBlendingNext,
+                            RTmotion::mcRuckig);
+    kernel.addFBToQueue(&nodes[i], 0, 0, 0, 0);
+  }
+
+  // The junctions are planned once in the next cycle
+  ASSERT_EQ(nodes[3].getStartVel(), 0);
+  kernel.updateLookAhead();
+
+  // Short moves never reach the blending velocity, the move before the
+  // reversal ends at standstill
+  ASSERT_GT(nodes[0].getEndVel(), 0.1);
+  ASSERT_LT(nodes[0].getEndVel(), 100);
+  ASSERT_GT(nodes[1].getEndVel(), nodes[0].getEndVel());
+  ASSERT_LT(abs(nodes[2].getEndVel() - nodes[0].getEndVel()), 0.0001);
+  ASSERT_EQ(nodes[3].getEndVel(), 0);
+  ASSERT_EQ(nodes[4].getEndVel(), 0);
+
+  traj_pro::ScurvePlannerOffLine scurve;
+  traj_pro::ScurveCondition condition;
+  condition.a_max = 10;
+  condition.j_max = 30;
+  for (size_t i = 0; i < 5; i++)
+  {
+    if (i > 0)
+    {
+      ASSERT_EQ(nodes[i].getStartPos(), nodes[i - 1].getEndPos());
+      ASSERT_EQ(nodes[i].getStartVel(), nodes[i - 1].getEndVel());
+    }
+    condition.q0 = nodes[i].getStartPos();
+    condition.q1 = nodes[i].getEndPos();
+    condition.v0 = nodes[i].getStartVel();
+    condition.v1 = nodes[i].getEndVel();
+    ASSERT_EQ(scurve.scurveCheckPosibility(condition),
+              RTmotion::mcErrorCodeGood);
+  }
+
+  // Pairwise blending asks for the blending velocity on the same moves
+  RTmotion::MotionKernel pairwise;
+  for (size_t i = 0; i < 2; i++)
+  {
+    nodes[i].reset();
+    nodes[i].setBasicParams(nullptr, RTmotion::mcMoveRelativeMode, dist[i],
+                            100, 10, 10, 30,
+                            i == 0 ? RTmotion::mcAborting :
+                                     RTmotion::mcBlendingNext,
+                            RTmotion::mcRuckig);
+    pairwise.addFBToQueue(&nodes[i], 0, 0, 0, 0);
+  }
+  ASSERT_EQ(nodes[0].getEndVel(), 100);
+  condition.q0 = nodes[0].getStartPos();
+  condition.q1 = nodes[0].getEndPos();
+  condition.v0 = nodes[0].getStartVel();
+  condition.v1 = nodes[0].getEndVel();
+  ASSERT_EQ(scurve.scurveCheckPosibility(condition),
+            RTmotion::mcErrorCodeScurveNotFeasible);
+}
+
+// Tests that the look-ahead brakes into a junction with the deceleration of
+// the move after it
+TEST_F(PlannerTest, LookAheadDeceleration)
+{
+  double end_vel[2];
+  const double dec[2] = { 10, 2 };
+  for (size_t n = 0; n < 2; n++)
+  {
+    RTmotion::ExecutionNode nodes[2];
+    RTmotion::MotionKernel kernel;
+    kernel.setLookAheadDepth(8);
+    for (size_t i = 0; i < 2; i++)
+    {
+      nodes[i].setBasicParams(nullptr, RTmotion::mcMoveRelativeMode, 1, 100,
+                              10, dec[n], 30,
+                              i == 0 ? RTmotion::mcAborting :
+                                       RTmotion::mcBlendingNext,
+                              RTmotion::mcRuckig);
+      kernel.addFBToQueue(&nodes[i], 0, 0, 0, 0);
+    }
+    kernel.updateLookAhead();
+    end_vel[n] = nodes[0].getEndVel();
+  }
+
+  // The second move stops within 1 unit at its deceleration
+  ASSERT_GT(end_vel[1], 0.1);
+  ASSERT_LT(end_vel[1], end_vel[0]);
+  ASSERT_LT(end_vel[1], sqrt(2 * dec[1] * 1));
+}
+
 int main(int argc, char** argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
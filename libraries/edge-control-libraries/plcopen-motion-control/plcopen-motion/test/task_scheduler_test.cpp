@@ -0,0 +1,181 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2025 Intel Corporation
+
+/**
+ * @file task_scheduler_test.cpp
+ *
+ * Maintainer: Yu Yan <yu.yan@intel.com>
+ *
+ */
+
+#include <fb/common/include/task_scheduler.hpp>
+#include <vector>
+#include "gtest/gtest.h"
+
+using namespace RTmotion;
+
+// Records the cycle in which it ran and the global run order
+class CountingBlock
+{
+public:
+  CountingBlock(std::vector<int>* log, int id) : log_(log), id_(id)
+  {
+  }
+
+  void runCycle()
+  {
+    runs_++;
+    log_->push_back(id_);
+  }
+
+  std::vector<int>* log_;
+  int id_;
+  int runs_ = 0;
+};
+
+class TaskSchedulerTest : public ::testing::Test
+{
+protected:
+  TaskSchedulerTest()
+  {
+  }
+
+  ~TaskSchedulerTest() override
+  {
+  }
+
+  void SetUp() override
+  {
+  }
+
+  void TearDown() override
+  {
+  }
+
+  TaskScheduler scheduler_;
+  std::vector<int> log_;
+};
+
+TEST_F(TaskSchedulerTest, RunRateAndPriority)
+{
+  CountingBlock fast(&log_, 0), slow(&log_, 1);
+
+  // Added before the motion task but has a lower priority
+  mcDINT slow_task = scheduler_.addTask(10, 5);
+  mcDINT fast_task = scheduler_.addTask(1, 0);
+  ASSERT_EQ(slow_task, 0);
+  ASSERT_EQ(fast_task, 1);
+  ASSERT_EQ(scheduler_.addMember(slow_task, &slow), mcTRUE);
+  ASSERT_EQ(scheduler_.addMember(fast_task, &fast), mcTRUE);
+
+  for (int i = 0; i < 100; i++)
+    scheduler_.runCycle();
+
+  ASSERT_EQ(fast.runs_, 100);
+  ASSERT_EQ(slow.runs_, 10);
+  ASSERT_EQ(scheduler_.getCycleCount(), 100u);
+
+  // The slow block always follows the fast block of the same cycle
+  for (size_t i = 1; i < log_.size(); i++)
+  {
+    if (log_[i] == 1)
+    {
+      ASSERT_EQ(log_[i - 1], 0);
+    }
+  }
+}
+
+TEST_F(TaskSchedulerTest, SpreadSlowTask)
+{
+  std::vector<CountingBlock> blocks;
+  for (int i = 0; i < 12; i++)
+    blocks.emplace_back(&log_, i);
+
+  // 6 blocks every cycle, 6 status reads at a tenth of the rate
+  mcDINT motion = scheduler_.addTask(1, 0);
+  mcDINT status = scheduler_.addTask(10, 1);
+  for (int i = 0; i < 6; i++)
+  {
+    scheduler_.addMember(motion, &blocks[i]);
+    scheduler_.addMember(status, &blocks[6 + i]);
+  }
+
+  // Each status read gets a cycle of its own
+  ASSERT_EQ(scheduler_.getPeakLoad(), 7u);
+  for (mcUDINT i = 0; i < 6; i++)
+    ASSERT_EQ(scheduler_.getPhase(status, i), i);
+
+  for (int i = 0; i < 30; i++)
+    scheduler_.runCycle();
+  for (int i = 0; i < 6; i++)
+  {
+    ASSERT_EQ(blocks[i].runs_, 30);
+    ASSERT_EQ(blocks[6 + i].runs_, 3);
+  }
+
+  // Without spreading all status reads stack on the same cycle
+  TaskScheduler naive;
+  motion = naive.addTask(1, 0);
+  status = naive.addTask(10, 1, mcFALSE);
+  for (int i = 0; i < 6; i++)
+  {
+    naive.addMember(motion, &blocks[i]);
+    naive.addMember(status, &blocks[6 + i]);
+  }
+  ASSERT_EQ(naive.getPeakLoad(), 12u);
+}
+
+TEST_F(TaskSchedulerTest, SpreadAcrossTasks)
+{
+  std::vector<CountingBlock> blocks;
+  for (int i = 0; i < 4; i++)
+    blocks.emplace_back(&log_, i);
+
+  // Two slow tasks with related periods avoid each other's cycles
+  mcDINT task_a = scheduler_.addTask(2, 1);
+  mcDINT task_b = scheduler_.addTask(4, 2);
+  scheduler_.addMember(task_a, &blocks[0]);
+  scheduler_.addMember(task_b, &blocks[1]);
+  scheduler_.addMember(task_b, &blocks[2]);
+  ASSERT_EQ(scheduler_.getPhase(task_a, 0), 0u);
+  ASSERT_EQ(scheduler_.getPhase(task_b, 0), 1u);
+  ASSERT_EQ(scheduler_.getPhase(task_b, 1), 3u);
+  ASSERT_EQ(scheduler_.getPeakLoad(), 1u);
+
+  // Restarting keeps members and their phases
+  for (int i = 0; i < 3; i++)
+    scheduler_.runCycle();
+  scheduler_.reset();
+  ASSERT_EQ(scheduler_.getCycleCount(), 0u);
+  for (int i = 0; i < 8; i++)
+    scheduler_.runCycle();
+  ASSERT_EQ(blocks[0].runs_, 2 + 4);
+  ASSERT_EQ(blocks[1].runs_, 1 + 2);
+  ASSERT_EQ(blocks[2].runs_, 0 + 2);
+}
+
+TEST_F(TaskSchedulerTest, InvalidRegistration)
+{
+  CountingBlock block(&log_, 0);
+
+  ASSERT_EQ(scheduler_.addTask(0, 0), -1);
+  ASSERT_EQ(scheduler_.addMember(0, &block), mcFALSE);
+
+  for (int i = 0; i < TASK_MAX_NUM; i++)
+    ASSERT_EQ(scheduler_.addTask(1, 0), i);
+  ASSERT_EQ(scheduler_.addTask(1, 0), -1);
+  ASSERT_EQ(scheduler_.getTaskNum(), (mcUDINT)TASK_MAX_NUM);
+
+  for (int i = 0; i < TASK_MEMBER_MAX_NUM; i++)
+    ASSERT_EQ(scheduler_.addMember(0, &block), mcTRUE);
+  ASSERT_EQ(scheduler_.addMember(0, &block), mcFALSE);
+  ASSERT_EQ(scheduler_.addMember(-1, &block), mcFALSE);
+  ASSERT_EQ(scheduler_.addMember(1, (CountingBlock*)nullptr), mcFALSE);
+  ASSERT_EQ(scheduler_.getMemberNum(0), (mcUDINT)TASK_MEMBER_MAX_NUM);
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
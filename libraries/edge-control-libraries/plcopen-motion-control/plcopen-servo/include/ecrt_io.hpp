@@ -34,13 +34,10 @@ public:
     domain1_ = domain;
   }
 
+protected:
+  mcUSINT* getProcessData(IO_TYPE ioType) override;
+
 private:
-  // read operation
-  MC_IO_ERROR_CODE getIOValueByEntry(PDO_ENTRY_INFO pdo_entry, mcUSINT bitNum,
-                                     mcBOOL& io_data) override;
-  // write operation
-  MC_IO_ERROR_CODE setIOValueByEntry(PDO_ENTRY_INFO pdo_entry, mcUSINT bitNum,
-                                     mcBOOL data) override;
   /* Dump enablekit object into plcopen object */
   PDO_ENTRY_INFO getPDOEntryInfo(servo_pdo_entry_info_t slave_pdo_entry_info);
   mcBOOL getInputOutputInfo(servo_sm_info_t servo_sm_info);
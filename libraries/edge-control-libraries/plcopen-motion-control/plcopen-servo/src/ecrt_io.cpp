@@ -38,6 +38,17 @@ void EcrtIO::runCycle()
 #endif
     }
   }
+  McIO::runCycle();
+}
+
+mcUSINT* EcrtIO::getProcessData(IO_TYPE ioType)
+{
+  // Inputs and outputs are offsets into the same domain
+  if (ioType != typeInput && ioType != typeOutput)
+  {
+    return nullptr;
+  }
+  return domain1_;
 }
 
 void EcrtIO::printIOInfo()
@@ -157,109 +168,7 @@ mcBOOL EcrtIO::initializeIO(mcUDINT slave_index)
     return mcFALSE;
   }
 
-  return mcTRUE;
-}
-
-MC_IO_ERROR_CODE EcrtIO::getIOValueByEntry(PDO_ENTRY_INFO pdo_entry,
-                                           mcUSINT bitNum, mcBOOL& io_data)
-{
-  switch (pdo_entry.bitlen)
-  {
-    case 8:
-      io_data = static_cast<mcBOOL>(
-          (MOTION_DOMAIN_READ_U8(domain1_ + pdo_entry.offset) >> bitNum) & 1);
-      break;
-    case 16:
-      io_data = static_cast<mcBOOL>(
-          (MOTION_DOMAIN_READ_U16(domain1_ + pdo_entry.offset) >> bitNum) & 1);
-      break;
-    case 32:
-      io_data = static_cast<mcBOOL>(
-          (MOTION_DOMAIN_READ_U32(domain1_ + pdo_entry.offset) >> bitNum) & 1);
-      break;
-    case 64:
-      io_data = static_cast<mcBOOL>(
-          (MOTION_DOMAIN_READ_U64(domain1_ + pdo_entry.offset) >> bitNum) & 1);
-      break;
-    default:
-      printf("Invalid bitlength %d for EtherCAT IO\n", pdo_entry.bitlen);
-      return mcIODataBitLengthError;
-  }
-
-  return mcIONoError;
-}
-
-MC_IO_ERROR_CODE EcrtIO::setIOValueByEntry(PDO_ENTRY_INFO pdo_entry,
-                                           mcUSINT bitNum, mcBOOL data)
-{
-  switch (pdo_entry.bitlen)
-  {
-    case 8: {
-      mcUSINT value_u8 = MOTION_DOMAIN_READ_U8(domain1_ + pdo_entry.offset);
-      if (data == mcTRUE)
-      {
-        MOTION_DOMAIN_WRITE_U8(domain1_ + pdo_entry.offset,
-                               value_u8 | (1 << bitNum));
-      }
-      else
-      {
-        MOTION_DOMAIN_WRITE_U8(domain1_ + pdo_entry.offset,
-                               value_u8 & (~(1 << bitNum)));
-      }
-      break;
-    }
-
-    case 16: {
-      mcUINT value_u16 = MOTION_DOMAIN_READ_U16(domain1_ + pdo_entry.offset);
-      if (data == mcTRUE)
-      {
-        MOTION_DOMAIN_WRITE_U16(domain1_ + pdo_entry.offset,
-                                value_u16 | (1 << bitNum));
-      }
-      else
-      {
-        MOTION_DOMAIN_WRITE_U16(domain1_ + pdo_entry.offset,
-                                value_u16 & (~(1 << bitNum)));
-      }
-      break;
-    }
-
-    case 32: {
-      mcUDINT value_u32 = MOTION_DOMAIN_READ_U32(domain1_ + pdo_entry.offset);
-      if (data == mcTRUE)
-      {
-        MOTION_DOMAIN_WRITE_U32(domain1_ + pdo_entry.offset,
-                                value_u32 | (1 << bitNum));
-      }
-      else
-      {
-        MOTION_DOMAIN_WRITE_U32(domain1_ + pdo_entry.offset,
-                                value_u32 & (~(1 << bitNum)));
-      }
-      break;
-    }
-
-    case 64: {
-      mcULINT value_u64 = MOTION_DOMAIN_READ_U64(domain1_ + pdo_entry.offset);
-      if (data == mcTRUE)
-      {
-        MOTION_DOMAIN_WRITE_U64(domain1_ + pdo_entry.offset,
-                                value_u64 | (1 << bitNum));
-      }
-      else
-      {
-        MOTION_DOMAIN_WRITE_U64(domain1_ + pdo_entry.offset,
-                                value_u64 & (~(1 << bitNum)));
-      }
-      break;
-    }
-
-    default:
-      printf("Invalid bitlength for EtherCAT IO\n");
-      return mcIODataBitLengthError;
-  }
-
-  return mcIONoError;
+  return compileIOLayout();
 }
 
 PDO_ENTRY_INFO
@@ -0,0 +1,487 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2025 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions
+// and limitations under the License.
+
+/**
+ * @brief A header file with declaration for the ACRN cross-VM messenger
+ * @file acrn_messenger.hpp
+ */
+#ifndef MC_GW__ACRN_MESSENGER_HPP_
+#define MC_GW__ACRN_MESSENGER_HPP_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/eventfd.h>
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace cross_vm_messenger
+{
+/**
+ * @class ShmDevice
+ * @brief Shared memory of the VMs with a doorbell to the peer.
+ */
+class ShmDevice
+{
+public:
+  virtual ~ShmDevice() {}
+  virtual char* base() const = 0;
+  virtual size_t size() const = 0;
+  /** Raise interrupt vector on the peer VM. */
+  virtual void ring(uint16_t peer, uint16_t vector) = 0;
+  /** Wait for a doorbell, returns 1 on a doorbell, 0 on timeout, -1 on error. */
+  virtual int wait(int timeout_ms) = 0;
+};
+
+/**
+ * @class UioIvshmemDevice
+ * @brief ivshmem PCI device bound to a UIO driver.
+ *
+ * BAR2 is the shared memory, BAR0 holds the ivshmem registers and the
+ * interrupts are read from /dev/uioN. Without BAR0 or the interrupt the
+ * device still works, ring() does nothing and wait() sleeps.
+ */
+class UioIvshmemDevice : public ShmDevice
+{
+public:
+  enum
+  {
+    REG_INTR_MASK = 0,
+    REG_INTR_STATUS = 1,
+    REG_IV_POSITION = 2,
+    REG_DOORBELL = 3,
+  };
+
+  UioIvshmemDevice(const int uio_nr = 0, const size_t mem_size = 4096)
+  {
+    char node_path[256] = {0};
+    shm_size_ = mem_size;
+
+    snprintf(node_path, sizeof(node_path), "/sys/class/uio/uio%d/device/resource2_wc", uio_nr);
+    shm_fd_ = open(node_path, O_RDWR);
+    if (shm_fd_ < 0) {
+      throw std::runtime_error("Open UIO device node ERROR!");
+    }
+    shm_addr_ = (char*)mmap(NULL, shm_size_, PROT_READ|PROT_WRITE, MAP_SHARED, shm_fd_, 0);
+    if (shm_addr_ == MAP_FAILED) {
+      shm_addr_ = nullptr;
+      close(shm_fd_);
+      throw std::runtime_error("mmap failed!");
+    }
+
+    snprintf(node_path, sizeof(node_path), "/sys/class/uio/uio%d/device/resource0", uio_nr);
+    reg_fd_ = open(node_path, O_RDWR);
+    if (reg_fd_ >= 0) {
+      void* regs = mmap(NULL, REG_SIZE, PROT_READ|PROT_WRITE, MAP_SHARED, reg_fd_, 0);
+      if (regs != MAP_FAILED) {
+        regs_ = (volatile uint32_t*)regs;
+        regs_[REG_INTR_MASK] = 0xffffffff;
+      }
+    }
+    if (regs_ == nullptr) {
+      std::cout << "WARNING: no ivshmem registers, doorbell disabled!" << std::endl;
+    }
+
+    snprintf(node_path, sizeof(node_path), "/dev/uio%d", uio_nr);
+    irq_fd_ = open(node_path, O_RDWR);
+    if (irq_fd_ >= 0) {
+      enableIrq();
+    } else {
+      std::cout << "WARNING: cannot open " << node_path << ", waiting without interrupt!" << std::endl;
+    }
+  }
+
+  virtual ~UioIvshmemDevice()
+  {
+    if (irq_fd_ >= 0) {
+      close(irq_fd_);
+    }
+    if (regs_ != nullptr) {
+      munmap((void*)regs_, REG_SIZE);
+    }
+    if (reg_fd_ >= 0) {
+      close(reg_fd_);
+    }
+    if (shm_addr_ != nullptr) {
+      munmap(shm_addr_, shm_size_);
+    }
+    if (shm_fd_ >= 0) {
+      close(shm_fd_);
+    }
+  }
+
+  char* base() const override { return shm_addr_; }
+  size_t size() const override { return shm_size_; }
+
+  /** Own ID on the ivshmem device, -1 without registers. */
+  int id() const
+  {
+    return (regs_ != nullptr) ? (int)regs_[REG_IV_POSITION] : -1;
+  }
+
+  void ring(uint16_t peer, uint16_t vector) override
+  {
+    if (regs_ != nullptr) {
+      regs_[REG_DOORBELL] = ((uint32_t)peer << 16) | vector;
+    }
+  }
+
+  int wait(int timeout_ms) override
+  {
+    if (irq_fd_ < 0) {
+      usleep(timeout_ms * 1000);
+      return 0;
+    }
+    struct pollfd pfd = {irq_fd_, POLLIN, 0};
+    int ret = poll(&pfd, 1, timeout_ms);
+    if (ret <= 0) {
+      return ret;
+    }
+    uint32_t count;
+    if (::read(irq_fd_, &count, sizeof(count)) != sizeof(count)) {
+      return -1;
+    }
+    if (regs_ != nullptr) {
+      (void)regs_[REG_INTR_STATUS];  // acknowledge INTx
+    }
+    enableIrq();
+    return 1;
+  }
+
+private:
+  void enableIrq()
+  {
+    // Re-arms INTx on uio_pci_generic, drivers without irqcontrol ignore it
+    uint32_t enable = 1;
+    if (::write(irq_fd_, &enable, sizeof(enable)) != sizeof(enable)) {
+      return;
+    }
+  }
+
+private:
+  static const size_t REG_SIZE = 256;
+  int shm_fd_ = -1;
+  int reg_fd_ = -1;
+  int irq_fd_ = -1;
+  size_t shm_size_ = 0;
+  char* shm_addr_ = nullptr;
+  volatile uint32_t* regs_ = nullptr;
+};
+
+/**
+ * @class MemfdDevice
+ * @brief Stand-in for the ivshmem BAR, one memfd mapped once per side.
+ *
+ * createPair() returns the two ends, each with its own mapping of the same
+ * memory and an eventfd as doorbell that the other end rings.
+ */
+class MemfdDevice : public ShmDevice
+{
+public:
+  static std::pair<std::shared_ptr<MemfdDevice>, std::shared_ptr<MemfdDevice>>
+  createPair(const size_t mem_size = 4096)
+  {
+    int fd = memfd_create("acrn_shm", 0);
+    if (fd < 0) {
+      throw std::runtime_error("memfd_create failed!");
+    }
+    if (ftruncate(fd, mem_size) < 0) {
+      close(fd);
+      throw std::runtime_error("ftruncate failed!");
+    }
+    std::shared_ptr<MemfdDevice> a(new MemfdDevice(fd, mem_size));
+    std::shared_ptr<MemfdDevice> b(new MemfdDevice(fd, mem_size));
+    close(fd);
+    a->peer_ = b.get();
+    b->peer_ = a.get();
+    return std::make_pair(a, b);
+  }
+
+  virtual ~MemfdDevice()
+  {
+    if (peer_ != nullptr) {
+      peer_->peer_ = nullptr;
+    }
+    munmap(shm_addr_, shm_size_);
+    close(event_fd_);
+  }
+
+  char* base() const override { return shm_addr_; }
+  size_t size() const override { return shm_size_; }
+
+  void ring(uint16_t, uint16_t) override
+  {
+    uint64_t one = 1;
+    if ((peer_ == nullptr) || (::write(peer_->event_fd_, &one, sizeof(one)) != sizeof(one))) {
+      return;
+    }
+  }
+
+  int wait(int timeout_ms) override
+  {
+    struct pollfd pfd = {event_fd_, POLLIN, 0};
+    int ret = poll(&pfd, 1, timeout_ms);
+    if (ret <= 0) {
+      return ret;
+    }
+    uint64_t count;
+    return (::read(event_fd_, &count, sizeof(count)) == sizeof(count)) ? 1 : -1;
+  }
+
+private:
+  MemfdDevice(int fd, size_t mem_size)
+  : shm_size_(mem_size)
+  {
+    shm_addr_ = (char*)mmap(NULL, shm_size_, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+    if (shm_addr_ == MAP_FAILED) {
+      throw std::runtime_error("mmap failed!");
+    }
+    event_fd_ = eventfd(0, EFD_NONBLOCK);
+    if (event_fd_ < 0) {
+      munmap(shm_addr_, shm_size_);
+      throw std::runtime_error("eventfd failed!");
+    }
+  }
+
+private:
+  size_t shm_size_ = 0;
+  char* shm_addr_ = nullptr;
+  int event_fd_ = -1;
+  MemfdDevice* peer_ = nullptr;
+};
+
+/**
+ * @class AcrnMessenger
+ * @brief Tear-free messages between VMs over a ShmDevice.
+ *
+ * The common usage step:
+ *   1. Both VMs assign the same channels in the same order, the side that
+ *      starts first passes reset = true.
+ *   2. Keep the Channel pointers returned by assign(), read() and write()
+ *      take them instead of a name.
+ *   3. The writer of a channel calls write(), which rings the peer. The
+ *      reader blocks in wait() and reads the channels whose sequence moved.
+ *
+ * Every channel is a seqlock: the writer makes the sequence odd, copies the
+ * payload and makes it even again, a reader retries until it copied the
+ * payload between two equal even sequences. Each channel has one writer.
+ */
+class AcrnMessenger
+{
+public:
+  static const uint32_t MAGIC = 0x4d4e5241;  // "ARNM"
+  static const uint16_t VERSION = 1;
+  static const size_t LINE = 64;
+  static const int READ_RETRIES = 1000;
+
+  struct SharedHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t n_channels;
+  };
+
+  struct SlotHeader {
+    std::atomic<uint32_t> seq;
+    uint32_t len;
+    uint32_t capacity;
+    uint32_t vector;
+  };
+
+  struct Channel {
+    std::string name;
+    SlotHeader* slot;
+    char* payload;
+    size_t capacity;
+    uint16_t vector;
+  };
+
+public:
+  AcrnMessenger(std::shared_ptr<ShmDevice> device, const uint16_t peer_id = 1, const bool reset = false)
+  : device_(device), peer_id_(peer_id)
+  {
+    if ((device_ == nullptr) || (device_->base() == nullptr) || (device_->size() < LINE)) {
+      throw std::runtime_error("No shared memory device!");
+    }
+    header_ = (SharedHeader*)device_->base();
+    next_ = LINE;
+    if (reset) {
+      this->reset();
+    }
+  }
+
+  virtual ~AcrnMessenger() {}
+
+  /** Clear the shared memory and mark it with the layout version. */
+  void reset()
+  {
+    memset(device_->base(), 0, device_->size());
+    header_->magic = MAGIC;
+    header_->version = VERSION;
+    header_->n_channels = 0;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+  }
+
+  /** The shared memory was reset by a peer of the same layout version. */
+  bool compatible() const
+  {
+    return (header_->magic == MAGIC) && (header_->version == VERSION);
+  }
+
+  /** Place the next channel, the returned handle stays valid for the messenger lifetime. */
+  Channel* assign(const std::string& name, const size_t size)
+  {
+    size_t capacity = alignLine(size);
+    if (next_ + LINE + capacity > device_->size()) {
+      std::cout << "ERROR: no enough space in shared memory! (available space="
+        << device_->size() - next_ << ")" << std::endl;
+      return nullptr;
+    }
+    std::unique_ptr<Channel> channel(new Channel);
+    channel->name = name;
+    channel->slot = (SlotHeader*)(device_->base() + next_);
+    channel->payload = device_->base() + next_ + LINE;
+    channel->capacity = capacity;
+    channel->vector = (uint16_t)channels_.size();
+    if (channel->slot->capacity == 0) {
+      channel->slot->capacity = (uint32_t)capacity;
+      channel->slot->vector = channel->vector;
+      header_->n_channels = (uint16_t)(channels_.size() + 1);
+    } else if (channel->slot->capacity != capacity) {
+      std::cout << "WARNING: channel " << name << " has " << channel->slot->capacity
+        << " bytes on the peer, " << capacity << " here!" << std::endl;
+    }
+    next_ += LINE + capacity;
+    channels_.push_back(std::move(channel));
+    return channels_.back().get();
+  }
+
+  Channel* channel(const std::string& name) const
+  {
+    for (auto& channel : channels_) {
+      if (channel->name == name) {
+        return channel.get();
+      }
+    }
+    return nullptr;
+  }
+
+  /** Publish a message and ring the peer, returns the bytes written. */
+  int write(Channel* channel, const void* buf, size_t size, const bool notify = true)
+  {
+    if ((channel == nullptr) || (buf == nullptr)) {
+      return 0;
+    }
+    if (size > channel->capacity) {
+      std::cout << "WARNING: the required size is larger than the assigned memory!" << std::endl;
+      size = channel->capacity;
+    }
+    SlotHeader* slot = channel->slot;
+    uint32_t seq = slot->seq.load(std::memory_order_relaxed);
+    // Full fences, they also drain the write-combining buffers of the BAR
+    slot->seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    memcpy(channel->payload, buf, size);
+    slot->len = (uint32_t)size;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    slot->seq.store(seq + 2, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (notify) {
+      device_->ring(peer_id_, channel->vector);
+    }
+    return (int)size;
+  }
+
+  /**
+   * Copy the last message, returns its length, 0 if no message was written
+   * yet, -1 if the writer kept it busy for READ_RETRIES attempts.
+   */
+  int read(const Channel* channel, void* buf, size_t size, uint32_t* seq = nullptr) const
+  {
+    if ((channel == nullptr) || (buf == nullptr)) {
+      return 0;
+    }
+    const SlotHeader* slot = channel->slot;
+    for (int i = 0; i < READ_RETRIES; i++) {
+      uint32_t begin = slot->seq.load(std::memory_order_acquire);
+      if (begin & 1) {
+        cpuRelax();
+        continue;
+      }
+      if (begin == 0) {
+        return 0;
+      }
+      size_t len = slot->len;
+      if (len > channel->capacity) {
+        len = channel->capacity;
+      }
+      if (len > size) {
+        len = size;
+      }
+      memcpy(buf, channel->payload, len);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (slot->seq.load(std::memory_order_relaxed) == begin) {
+        if (seq != nullptr) {
+          *seq = begin;
+        }
+        return (int)len;
+      }
+    }
+    return -1;
+  }
+
+  /** Sequence of the last message, compare it to skip a read. */
+  uint32_t sequence(const Channel* channel) const
+  {
+    return channel->slot->seq.load(std::memory_order_acquire);
+  }
+
+  /** Block until the peer rings or timeout_ms passed. */
+  int wait(int timeout_ms)
+  {
+    return device_->wait(timeout_ms);
+  }
+
+private:
+  static inline size_t alignLine(size_t size)
+  {
+    return (size + LINE - 1) & ~(LINE - 1);
+  }
+
+  static inline void cpuRelax()
+  {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+  }
+
+private:
+  std::shared_ptr<ShmDevice> device_;
+  uint16_t peer_id_;
+  SharedHeader* header_ = nullptr;
+  size_t next_ = 0;
+  std::vector<std::unique_ptr<Channel>> channels_;
+};
+
+}  // namespace cross_vm_messenger
+#endif  // MC_GW__ACRN_MESSENGER_HPP_
@@ -29,12 +29,16 @@
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <assert.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
 #include <bits/stdc++.h>
 #ifdef ENABLE_SHM_RINGBUF
 #include <shmringbuf.h>
 #endif
 #ifdef ENABLE_SHM_ACRN
 #include "agvm_plcshm_acrn/acrn_shm.hpp"
+#include "agvm_plcshm_acrn/acrn_messenger.hpp"
 #endif
 
 static const rclcpp::Logger LOGGER = rclcpp::get_logger("agvm_plcshm_node");
@@ -85,6 +89,12 @@ public:
     AgvmPlcShmNode();
     ~AgvmPlcShmNode()
     {
+#ifdef ENABLE_SHM_ACRN
+        mListenerStop = true;
+        if (mListener.joinable()) {
+            mListener.join();
+        }
+#endif
         delete ctrl;
         delete agvmInfo;
     }
@@ -96,12 +106,20 @@ private:
     void agvmEmergCallback(const std_msgs::msg::Bool::SharedPtr enable);
     void relPoseCallback(const geometry_msgs::msg::Pose::SharedPtr pose);
     void timerCallback(void);
+    void sendCommands(void);
+    int receiveState(void);
+    void publishState(double rate);
+#ifdef ENABLE_SHM_ACRN
+    void acrnListener(void);
+#endif
     
 private:
     int mCtrlAddr;
     int mAgvmInfoAddr;
     int mPubRate;
     bool mEnableAcrnShm = true;
+    bool mEnableAcrnDoorbell = false;
+    int mAcrnPeerId = 1;
     std::string mOdomFrame;
     std::string mBaseFrame;
     double mPosRZPriv = 0;
@@ -119,9 +137,19 @@ private:
     rclcpp::Publisher<std_msgs::msg::Bool>::SharedPtr mRelMoveBusyPub;
     rclcpp::TimerBase::SharedPtr mTimer;
     std::shared_ptr<tf2_ros::TransformBroadcaster> mTFBroadcaster;
+    // Commands are written by the executor and read by the doorbell listener
+    std::mutex mCtrlMutex;
 
 #ifdef ENABLE_SHM_ACRN
     std::shared_ptr<cross_vm_messenger::AcrnSharedMemory> acrn_shm_;
+    const cross_vm_messenger::AcrnSharedMemory::MemoryUsage* mStateRegion = nullptr;
+    const cross_vm_messenger::AcrnSharedMemory::MemoryUsage* mCmdRegion = nullptr;
+    // Doorbell mode: the state is received and published on arrival
+    std::shared_ptr<cross_vm_messenger::AcrnMessenger> acrn_messenger_;
+    cross_vm_messenger::AcrnMessenger::Channel* mStateChannel = nullptr;
+    cross_vm_messenger::AcrnMessenger::Channel* mCmdChannel = nullptr;
+    std::thread mListener;
+    std::atomic<bool> mListenerStop{false};
 #endif // ENABLE_SHM_ACRN
 };
 
@@ -131,10 +159,22 @@ AgvmPlcShmNode::AgvmPlcShmNode() :
     getParameters();
     init();
 #ifdef ENABLE_SHM_ACRN
-    if(mEnableAcrnShm) {
+    if(mEnableAcrnShm && mEnableAcrnDoorbell) {
+      auto device = std::make_shared<cross_vm_messenger::UioIvshmemDevice>(0, 8192);
+      acrn_messenger_ = std::make_shared<cross_vm_messenger::AcrnMessenger>(device, mAcrnPeerId);
+      // Keep a layout set up by the PLC VM, only a missing one is reset
+      if (!acrn_messenger_->compatible()) {
+        acrn_messenger_->reset();
+      }
+      mStateChannel = acrn_messenger_->assign("amr_state", MSG_LEN);
+      mCmdChannel = acrn_messenger_->assign("amr_cmd", MSG_LEN);
+      mListener = std::thread(&AgvmPlcShmNode::acrnListener, this);
+    } else if(mEnableAcrnShm) {
       acrn_shm_ = std::make_shared<cross_vm_messenger::AcrnSharedMemory>(0, 8192);
       acrn_shm_->assign("amr_state", MSG_LEN);
       acrn_shm_->assign("amr_cmd", MSG_LEN);
+      mStateRegion = acrn_shm_->region("amr_state");
+      mCmdRegion = acrn_shm_->region("amr_cmd");
     }
 #endif
 }
@@ -152,6 +192,12 @@ void AgvmPlcShmNode::getParameters(void)
 
     declare_parameter("enable_acrn_shm", true);
     get_parameter("enable_acrn_shm", mEnableAcrnShm);
+
+    declare_parameter("enable_acrn_doorbell", false);
+    get_parameter("enable_acrn_doorbell", mEnableAcrnDoorbell);
+
+    declare_parameter("acrn_peer_id", 1);
+    get_parameter("acrn_peer_id", mAcrnPeerId);
 }
 
 void AgvmPlcShmNode::init(void)
@@ -184,30 +230,49 @@ void AgvmPlcShmNode::init(void)
     mRelMoveBusyPub = create_publisher<std_msgs::msg::Bool>(
         "/agvm_plcshm/move_relative_busy", rclcpp::SystemDefaultsQoS());
         
-    mTimer = create_wall_timer(
-        std::chrono::nanoseconds((int64_t)(1000000000.0 / mPubRate)), 
-        std::bind(&AgvmPlcShmNode::timerCallback, this));
+    bool polling = true;
+#ifdef ENABLE_SHM_ACRN
+    polling = !(mEnableAcrnShm && mEnableAcrnDoorbell);
+#endif
+    if (polling) {
+        mTimer = create_wall_timer(
+            std::chrono::nanoseconds((int64_t)(1000000000.0 / mPubRate)), 
+            std::bind(&AgvmPlcShmNode::timerCallback, this));
+    }
 
     RCLCPP_INFO(get_logger(), "AgvmPlcShmNode initial complete.");
 }
 
 void AgvmPlcShmNode::cmdVelCallback(const geometry_msgs::msg::Twist::SharedPtr cmdVel)
 {
-    RCLCPP_INFO(get_logger(), "Get cmdVel: %f %f %f\n", cmdVel->linear.x, cmdVel->linear.y, cmdVel->angular.z);
-    ctrl->mTransH = cmdVel->linear.y;
-    ctrl->mTransV = cmdVel->linear.x;
-    ctrl->mTwist = cmdVel->angular.z;
+    RCLCPP_DEBUG(get_logger(), "Get cmdVel: %f %f %f\n", cmdVel->linear.x, cmdVel->linear.y, cmdVel->angular.z);
+    {
+        std::lock_guard<std::mutex> lock(mCtrlMutex);
+        ctrl->mTransH = cmdVel->linear.y;
+        ctrl->mTransV = cmdVel->linear.x;
+        ctrl->mTwist = cmdVel->angular.z;
+    }
+    if (!mTimer) {
+        sendCommands();
+    }
 }
 
 void AgvmPlcShmNode::agvmEmergCallback(const std_msgs::msg::Bool::SharedPtr enable)
 {
-    ctrl->mEmergStop = enable->data;
-    ctrl->mEnable = !enable->data;
-    RCLCPP_INFO(get_logger(), "Enable AGV: %d\n", ctrl->mEnable);
+    {
+        std::lock_guard<std::mutex> lock(mCtrlMutex);
+        ctrl->mEmergStop = enable->data;
+        ctrl->mEnable = !enable->data;
+        RCLCPP_INFO(get_logger(), "Enable AGV: %d\n", ctrl->mEnable);
+    }
+    if (!mTimer) {
+        sendCommands();
+    }
 }
 
 void AgvmPlcShmNode::relPoseCallback(const geometry_msgs::msg::Pose::SharedPtr pose)
 {
+	std::unique_lock<std::mutex> lock(mCtrlMutex);
 	ctrl->mRelX = pose->position.x;
 	ctrl->mRelY = pose->position.y;
 	Eigen::AngleAxisd tmpRot(Eigen::Quaterniond(
@@ -228,13 +293,25 @@ void AgvmPlcShmNode::relPoseCallback(const geometry_msgs::msg::Pose::SharedPtr p
 		ctrl->mRelX, ctrl->mRelY, ctrl->mRelRZ);
 		
 	ctrl->mRelMove = true;
+	lock.unlock();
+    if (!mTimer) {
+        sendCommands();
+    }
 }
 
 void AgvmPlcShmNode::timerCallback(void)
 {
+    sendCommands();
+    receiveState();
+    publishState(mPubRate);
+}
 
-    // Send commands
-    memcpy(c_buf, ctrl, sizeof(*ctrl));
+void AgvmPlcShmNode::sendCommands(void)
+{
+    {
+        std::lock_guard<std::mutex> lock(mCtrlMutex);
+        memcpy(c_buf, ctrl, sizeof(*ctrl));
+    }
     int ret = 0;
 #ifdef ENABLE_SHM_RINGBUF
     if (!shm_blkbuf_full(handle_c))
@@ -244,31 +321,42 @@ void AgvmPlcShmNode::timerCallback(void)
     }
 #endif
 #ifdef ENABLE_SHM_ACRN
-    if(mEnableAcrnShm) {
-        ret = acrn_shm_->write("amr_cmd", c_buf, sizeof(c_buf));
+    if(acrn_messenger_) {
+        ret = acrn_messenger_->write(mCmdChannel, c_buf, sizeof(c_buf));
+    } else if(mEnableAcrnShm) {
+        ret = acrn_shm_->write(mCmdRegion, c_buf, sizeof(c_buf));
     }
 #endif
+    (void)ret;
+}
 
-    // Receive state
+int AgvmPlcShmNode::receiveState(void)
+{
+    int ret = 0;
 #ifdef ENABLE_SHM_RINGBUF
-    ret = 0;
     if (!shm_blkbuf_empty(handle_s))
     {
       ret = shm_blkbuf_read(handle_s, s_buf, sizeof(s_buf));
     }
 #endif
 #ifdef ENABLE_SHM_ACRN
-    if(mEnableAcrnShm) {
-        ret = acrn_shm_->read("amr_state", s_buf, sizeof(c_buf));
+    if(acrn_messenger_) {
+        ret = acrn_messenger_->read(mStateChannel, s_buf, sizeof(s_buf));
+    } else if(mEnableAcrnShm) {
+        ret = acrn_shm_->read(mStateRegion, s_buf, sizeof(s_buf));
     }
 #endif
 
-    if (ret)
+    if (ret > 0)
     {
       memcpy(agvmInfo, s_buf, sizeof(*agvmInfo));
       RCLCPP_DEBUG(LOGGER, "%s: receive %d bytes\n", __FUNCTION__, ret);
     }
+    return ret;
+}
 
+void AgvmPlcShmNode::publishState(double rate)
+{
     // Publish ROS topics
     auto currentTime = tf2_ros::toMsg(tf2::get_now());
     geometry_msgs::msg::TransformStamped odomTrans;
@@ -278,16 +366,19 @@ void AgvmPlcShmNode::timerCallback(void)
     mOdom.child_frame_id = mBaseFrame;
     mOdom.header.stamp = currentTime;
     
-    mOdom.twist.twist.linear.x = (agvmInfo->mPosX - mOdom.pose.pose.position.x) * mPubRate;
-    mOdom.twist.twist.linear.y = (agvmInfo->mPosY - mOdom.pose.pose.position.y) * mPubRate;
-    mOdom.twist.twist.angular.z = (agvmInfo->mPosRZ - mPosRZPriv) * mPubRate;
+    mOdom.twist.twist.linear.x = (agvmInfo->mPosX - mOdom.pose.pose.position.x) * rate;
+    mOdom.twist.twist.linear.y = (agvmInfo->mPosY - mOdom.pose.pose.position.y) * rate;
+    mOdom.twist.twist.angular.z = (agvmInfo->mPosRZ - mPosRZPriv) * rate;
     mOdom.pose.pose.position.x = agvmInfo->mPosX;
     mOdom.pose.pose.position.y = agvmInfo->mPosY;
     mOdom.pose.pose.position.z = 0;
-    RCLCPP_INFO(get_logger(), "AGV cmd: %f %f %f", ctrl->mTransV, ctrl->mTransH, ctrl->mTwist);
-    RCLCPP_INFO(get_logger(), "AGV pose: %f %f %f", agvmInfo->mPosX, agvmInfo->mPosY, agvmInfo->mPosRZ);
-    RCLCPP_INFO(get_logger(), "AGV vel: %f %f %f", agvmInfo->mVelX, agvmInfo->mVelY, agvmInfo->mVelRZ);
-    RCLCPP_INFO(get_logger(), "AGV mOdom: %f %f %f\n", mOdom.twist.twist.linear.x, mOdom.twist.twist.linear.y, mOdom.twist.twist.angular.z);
+    {
+        std::lock_guard<std::mutex> lock(mCtrlMutex);
+        RCLCPP_DEBUG(get_logger(), "AGV cmd: %f %f %f", ctrl->mTransV, ctrl->mTransH, ctrl->mTwist);
+    }
+    RCLCPP_DEBUG(get_logger(), "AGV pose: %f %f %f", agvmInfo->mPosX, agvmInfo->mPosY, agvmInfo->mPosRZ);
+    RCLCPP_DEBUG(get_logger(), "AGV vel: %f %f %f", agvmInfo->mVelX, agvmInfo->mVelY, agvmInfo->mVelRZ);
+    RCLCPP_DEBUG(get_logger(), "AGV mOdom: %f %f %f\n", mOdom.twist.twist.linear.x, mOdom.twist.twist.linear.y, mOdom.twist.twist.angular.z);
 
     tf2::Quaternion tmpQuet;
     tmpQuet.setRPY(0, 0, agvmInfo->mPosRZ);
@@ -320,6 +411,34 @@ void AgvmPlcShmNode::timerCallback(void)
 	mRelMoveBusyPub->publish(mRelMoveBusy);
 }
 
+#ifdef ENABLE_SHM_ACRN
+void AgvmPlcShmNode::acrnListener(void)
+{
+    uint32_t seq = 0;
+    auto last = std::chrono::steady_clock::now();
+
+    while (!mListenerStop) {
+        // Woken by the doorbell of the PLC VM, the timeout only checks for stop
+        if (acrn_messenger_->wait(100) < 0) {
+            RCLCPP_WARN(LOGGER, "%s: waiting for the doorbell failed\n", __FUNCTION__);
+        }
+        if (acrn_messenger_->sequence(mStateChannel) == seq) {
+            continue;
+        }
+        int ret = acrn_messenger_->read(mStateChannel, s_buf, sizeof(s_buf), &seq);
+        if (ret <= 0) {
+            continue;
+        }
+        memcpy(agvmInfo, s_buf, sizeof(*agvmInfo));
+
+        auto now = std::chrono::steady_clock::now();
+        double dt = std::chrono::duration<double>(now - last).count();
+        last = now;
+        publishState((dt > 0) ? 1.0 / dt : mPubRate);
+    }
+}
+#endif
+
 int main(int argc, char * argv[]) 
 {
     assert(CHAR_BIT * sizeof (float) == 32);
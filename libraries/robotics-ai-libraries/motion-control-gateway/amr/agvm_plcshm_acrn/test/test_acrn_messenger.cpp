@@ -0,0 +1,165 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2025 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions
+// and limitations under the License.
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "agvm_plcshm_acrn/acrn_messenger.hpp"
+
+using cross_vm_messenger::AcrnMessenger;
+using cross_vm_messenger::MemfdDevice;
+
+#define MSG_LEN 512
+
+/* Two messengers on the two ends of a memfd, as the ROS and the PLC VM */
+class AcrnMessengerTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    auto devices = MemfdDevice::createPair(8192);
+    ros_ = std::make_shared<AcrnMessenger>(devices.first, 1, true);
+    plc_ = std::make_shared<AcrnMessenger>(devices.second, 0, false);
+    ros_state_ = ros_->assign("amr_state", MSG_LEN);
+    ros_cmd_ = ros_->assign("amr_cmd", MSG_LEN);
+    plc_state_ = plc_->assign("amr_state", MSG_LEN);
+    plc_cmd_ = plc_->assign("amr_cmd", MSG_LEN);
+  }
+
+  std::shared_ptr<AcrnMessenger> ros_;
+  std::shared_ptr<AcrnMessenger> plc_;
+  AcrnMessenger::Channel* ros_state_;
+  AcrnMessenger::Channel* ros_cmd_;
+  AcrnMessenger::Channel* plc_state_;
+  AcrnMessenger::Channel* plc_cmd_;
+};
+
+TEST_F(AcrnMessengerTest, Layout)
+{
+  ASSERT_NE(ros_state_, nullptr);
+  ASSERT_NE(ros_cmd_, nullptr);
+  EXPECT_TRUE(plc_->compatible());
+  EXPECT_EQ(ros_->channel("amr_cmd"), ros_cmd_);
+  EXPECT_EQ(ros_->channel("none"), nullptr);
+  EXPECT_EQ(ros_state_->capacity, (size_t)MSG_LEN);
+  EXPECT_EQ(plc_state_->slot->capacity, (uint32_t)MSG_LEN);
+  EXPECT_EQ(ros_->assign("too_large", 8192), nullptr);
+}
+
+TEST_F(AcrnMessengerTest, ReadWrite)
+{
+  char buf[MSG_LEN];
+  char out[MSG_LEN];
+  uint32_t seq = 0;
+
+  EXPECT_EQ(ros_->read(ros_state_, buf, sizeof(buf)), 0);
+  EXPECT_EQ(ros_->wait(0), 0);
+
+  memset(out, 0x5a, sizeof(out));
+  EXPECT_EQ(plc_->write(plc_state_, out, 100), 100);
+  EXPECT_EQ(ros_->wait(1000), 1);
+  EXPECT_EQ(ros_->read(ros_state_, buf, sizeof(buf), &seq), 100);
+  EXPECT_EQ(memcmp(buf, out, 100), 0);
+  EXPECT_EQ(seq, 2u);
+  EXPECT_EQ(ros_->sequence(ros_state_), 2u);
+
+  // The other direction does not wake the writer
+  EXPECT_EQ(ros_->write(ros_cmd_, out, sizeof(out)), MSG_LEN);
+  EXPECT_EQ(ros_->wait(0), 0);
+  EXPECT_EQ(plc_->wait(0), 1);
+  EXPECT_EQ(plc_->read(plc_cmd_, buf, sizeof(buf)), MSG_LEN);
+
+  // Larger than the channel is cut to its capacity
+  char large[2 * MSG_LEN] = {0};
+  EXPECT_EQ(plc_->write(plc_state_, large, sizeof(large)), MSG_LEN);
+  EXPECT_EQ(ros_->read(ros_state_, buf, 10, &seq), 10);
+  EXPECT_EQ(seq, 4u);
+}
+
+TEST_F(AcrnMessengerTest, DoorbellWakeup)
+{
+  std::atomic<int> woken(0);
+  char buf[MSG_LEN] = {0};
+  auto start = std::chrono::steady_clock::now();
+  std::chrono::steady_clock::time_point received;
+
+  std::thread reader([&]() {
+    if (ros_->wait(5000) == 1) {
+      received = std::chrono::steady_clock::now();
+      woken = ros_->read(ros_state_, buf, sizeof(buf));
+    }
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  const char msg[] = "state";
+  plc_->write(plc_state_, msg, sizeof(msg));
+  reader.join();
+
+  EXPECT_EQ(woken.load(), (int)sizeof(msg));
+  EXPECT_STREQ(buf, msg);
+  // Woken by the doorbell, well before the 5 s timeout
+  EXPECT_LT(std::chrono::duration_cast<std::chrono::milliseconds>(received - start).count(), 1000);
+}
+
+TEST_F(AcrnMessengerTest, TearFree)
+{
+  const int words = MSG_LEN / sizeof(uint64_t);
+  std::atomic<bool> stop(false);
+  uint64_t reads = 0, torn = 0, busy = 0;
+
+  std::thread writer([&]() {
+    uint64_t msg[words];
+    for (uint64_t n = 1; !stop; n++) {
+      for (int i = 0; i < words; i++) {
+        msg[i] = n;
+      }
+      plc_->write(plc_state_, msg, sizeof(msg), false);
+    }
+  });
+  auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(300);
+  uint64_t last = 0;
+  while (std::chrono::steady_clock::now() < end) {
+    uint64_t msg[words];
+    int ret = ros_->read(ros_state_, msg, sizeof(msg));
+    if (ret < 0) {
+      busy++;
+      continue;
+    }
+    if (ret == 0) {
+      continue;
+    }
+    reads++;
+    for (int i = 1; i < words; i++) {
+      if (msg[i] != msg[0]) {
+        torn++;
+        break;
+      }
+    }
+    EXPECT_GE(msg[0], last);
+    last = msg[0];
+  }
+  stop = true;
+  writer.join();
+
+  EXPECT_GT(reads, 0u);
+  EXPECT_EQ(torn, 0u);
+  std::cout << reads << " reads, " << busy << " busy" << std::endl;
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
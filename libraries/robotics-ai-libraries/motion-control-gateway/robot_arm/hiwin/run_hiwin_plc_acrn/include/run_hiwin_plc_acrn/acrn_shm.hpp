@@ -85,9 +85,7 @@ public:
 
   void reset()
   {
-    for (int i = 0; i < (int)shm_size_; i++) {
-      shm_addr_[i] = 0;
-    }
+    memset(shm_addr_, 0, shm_size_);
     MemoryUsage use;
     shm_use_.clear();
     use.start = shm_addr_;
@@ -116,6 +114,43 @@ public:
     return true;
   }
 
+  /** Resolve a region once, the pointer stays valid until reset(). */
+  const MemoryUsage* region(const std::string& use) const
+  {
+    auto mem_use = shm_use_.find(use);
+    if(mem_use == shm_use_.end()){
+      std::cout << "WARNING: did NOT find the assigned memory! " << std::endl;
+      return nullptr;
+    }
+    return &mem_use->second;
+  }
+
+  int read(const MemoryUsage* mem_use, char* buf, int size) const
+  {
+    if ((buf == nullptr) || (mem_use == nullptr)){
+      return 0;
+    }
+    size_t n = size;
+    if(n > mem_use->len){
+      n = mem_use->len;
+    }
+    memcpy(buf, mem_use->start, n);
+    return n;
+  }
+
+  int write(const MemoryUsage* mem_use, char* buf, int size) const
+  {
+    if ((buf == nullptr) || (mem_use == nullptr)){
+      return 0;
+    }
+    size_t n = size;
+    if(n > mem_use->len){
+      n = mem_use->len;
+    }
+    memcpy(mem_use->start, buf, n);
+    return n;
+  }
+
   int read(std::string use, char* buf, int size) const
   {
     if (buf == nullptr){
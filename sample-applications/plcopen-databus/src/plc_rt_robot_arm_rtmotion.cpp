@@ -15,6 +15,7 @@
 #include <fb/public/include/fb_read_actual_position.hpp>
 #include <fb/public/include/fb_read_actual_velocity.hpp>
 #include <fb/common/include/global.hpp>
+#include <fb/common/include/task_scheduler.hpp>
 #include <ecrt_config.hpp>
 #include <ecrt_servo.hpp>
 #include <errno.h>
@@ -430,6 +431,21 @@ void* rt_func(void* arg)
   init_rtmotion(servo, my_servo, config, axis, fb_power, read_pos, read_vel,fb_set_position, move_abs);
   INFO_PRINT("Function blocks initialized.\n");
 
+  /* Motion blocks run every cycle, status reads for the HMI at 100 Hz and
+   * spread over the cycles of their period */
+  TaskScheduler scheduler;
+  unsigned int status_divider = cycle_us < 10000 ? 10000 / cycle_us : 1;
+  mcDINT motion_task          = scheduler.addTask(1, 0);
+  mcDINT status_task          = scheduler.addTask(status_divider, 1);
+  for (size_t i = 0; i < JOINT_NUM; i++)
+  {
+    scheduler.addMember(motion_task, axis[i]);
+    scheduler.addMember(motion_task, fb_power[i]);
+    scheduler.addMember(motion_task, fb_set_position[i]);
+    scheduler.addMember(status_task, read_pos[i]);
+    scheduler.addMember(status_task, read_vel[i]);
+  }
+
   /* Variables used for reading cache PMU counters */
   uint64_t cnt0_0 = 0, cnt0_1 = 0, cnt1_0 = 0, cnt1_1 = 0, cnt2_0 = 0,
            cnt2_1 = 0, cnt3_0 = 0, cnt3_1 = 0;
@@ -544,14 +560,7 @@ void* rt_func(void* arg)
       }
     }
     
-    for (size_t i = 0; i < JOINT_NUM; i++)
-    {
-      axis[i]->runCycle();
-      fb_power[i]->runCycle();
-      fb_set_position[i]->runCycle();
-      read_pos[i]->runCycle();
-      read_vel[i]->runCycle();
-    }
+    scheduler.runCycle();
 
     /* Print axis pos and vel when verbose enabled */
     if (verbose)
@@ -559,7 +568,7 @@ void* rt_func(void* arg)
       for (size_t i = 0; i < JOINT_NUM; i++)
       {
         printf("Current position - %ld: %f,\tvelocity: %f\n", i,
-               read_pos[i]->getFloatValue(), read_vel[i]->getFloatValue());
+               axis[i]->toUserPos(), axis[i]->toUserVel());
       }
     }
 
@@ -631,10 +640,11 @@ void* rt_func(void* arg)
     }
     
 
-    /* Update joint states */
+    /* Update joint states, read_pos only runs in the 100 Hz status task, so
+     * the published state is read from the axes of this cycle */
     for (size_t i = 0; i < JOINT_NUM; i++)
       if (power_on == mcTRUE)
-        joint_state.joint_pos[i] = read_pos[i]->getFloatValue();
+        joint_state.joint_pos[i] = axis[i]->toUserPos();
 
     memcpy(s_buf, &joint_state, sizeof(joint_state));
     if (!shm_blkbuf_full(handle_s))